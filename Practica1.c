@@ -19,12 +19,21 @@ typedef struct Proceso {
     struct Proceso *siguiente;
 } Proceso;
 
+typedef struct BloqueProcesos {
+    Proceso *nodos;
+    int capacidad;
+    struct BloqueProcesos *siguiente;
+} BloqueProcesos;
+
 /* ==================== VARIABLES GLOBALES ==================== */
 
 int *memoria = NULL;
 Particion *tabla_particiones = NULL;
 Proceso *lista_procesos = NULL;
 Proceso *lista_procesos_terminados = NULL;
+BloqueProcesos *bloques_procesos = NULL;
+Proceso *nodos_libres = NULL;
+int capacidad_pool = 0;
 int num_particiones = 0;
 int tamano_total_memoria = 0;
 int tamano_particion = 0;
@@ -33,6 +42,10 @@ int contador_procesos = 1;
 /* ==================== PROTOTIPOS DE FUNCIONES ==================== */
 
 void inicializar_memoria(void);
+int pool_crecer(int cantidad);
+Proceso* pool_obtener(void);
+void pool_devolver(Proceso *nodo);
+void pool_destruir(void);
 void agregar_proceso(int id, int tamano, int direccion);
 int eliminar_proceso(int id);
 Proceso* buscar_proceso(int id);
@@ -167,16 +180,78 @@ void inicializar_memoria(void) {
         tabla_particiones[i].estado = 0;
     }
     
+    if (!pool_crecer(num_particiones)) {
+        printf("Error: No se pudo asignar memoria para el pool de procesos.\n");
+        free(memoria);
+        free(tabla_particiones);
+        exit(1);
+    }
+    
     printf(">>> Memoria inicializada exitosamente.\n");
 }
 
+/* ==================== FUNCIONES DEL POOL DE PROCESOS ==================== */
+
+int pool_crecer(int cantidad) {
+    BloqueProcesos *bloque;
+    int i;
+    
+    if (cantidad < 16) {
+        cantidad = 16;
+    }
+    
+    bloque = (BloqueProcesos *)malloc(sizeof(BloqueProcesos) + cantidad * sizeof(Proceso));
+    if (bloque == NULL) {
+        return 0;
+    }
+    bloque->nodos = (Proceso *)(bloque + 1);
+    bloque->capacidad = cantidad;
+    bloque->siguiente = bloques_procesos;
+    bloques_procesos = bloque;
+    
+    for (i = cantidad - 1; i >= 0; i--) {
+        bloque->nodos[i].siguiente = nodos_libres;
+        nodos_libres = &bloque->nodos[i];
+    }
+    capacidad_pool += cantidad;
+    return 1;
+}
+
+Proceso* pool_obtener(void) {
+    Proceso *nodo;
+    
+    if (nodos_libres == NULL && !pool_crecer(capacidad_pool)) {
+        return NULL;
+    }
+    nodo = nodos_libres;
+    nodos_libres = nodo->siguiente;
+    return nodo;
+}
+
+void pool_devolver(Proceso *nodo) {
+    nodo->siguiente = nodos_libres;
+    nodos_libres = nodo;
+}
+
+void pool_destruir(void) {
+    BloqueProcesos *bloque;
+    
+    while (bloques_procesos != NULL) {
+        bloque = bloques_procesos;
+        bloques_procesos = bloque->siguiente;
+        free(bloque);
+    }
+    nodos_libres = NULL;
+    capacidad_pool = 0;
+}
+
 /* ==================== FUNCIONES DE LISTA ENLAZADA ==================== */
 
 void agregar_proceso(int id, int tamano, int direccion) {
     Proceso *nuevo;
     Proceso *actual;
     
-    nuevo = (Proceso *)malloc(sizeof(Proceso));
+    nuevo = pool_obtener();
     if (nuevo == NULL) {
         printf("Error: No se pudo asignar memoria para el proceso.\n");
         return;
@@ -226,7 +301,7 @@ int eliminar_proceso(int id) {
     }
     
     temp = actual;
-    free(temp);
+    pool_devolver(temp);
     return 1;
 }
 
@@ -247,7 +322,7 @@ void agregar_proceso_terminado(int id, int tamano, int direccion) {
     Proceso *nuevo;
     Proceso *actual;
     
-    nuevo = (Proceso *)malloc(sizeof(Proceso));
+    nuevo = pool_obtener();
     if (nuevo == NULL) {
         printf("Error: No se pudo asignar memoria para el proceso terminado.\n");
         return;
@@ -500,22 +575,9 @@ void mostrar_procesos_terminados(void) {
 /* ==================== FUNCION DE LIMPIEZA ==================== */
 
 void liberar_recursos(void) {
-    Proceso *actual;
-    Proceso *temp;
-    
-    actual = lista_procesos;
-    while (actual != NULL) {
-        temp = actual;
-        actual = actual->siguiente;
-        free(temp);
-    }
-    
-    actual = lista_procesos_terminados;
-    while (actual != NULL) {
-        temp = actual;
-        actual = actual->siguiente;
-        free(temp);
-    }
+    pool_destruir();
+    lista_procesos = NULL;
+    lista_procesos_terminados = NULL;
     
     if (memoria != NULL) {
         free(memoria);
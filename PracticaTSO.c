@@ -6,14 +6,61 @@
  *Materia: Taller de Sistemas Operativos
  */
 
+/* Habilita clock_gettime() en sistemas POSIX aun compilando con -ansi */
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <string.h>
 #include <time.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define MAPEO_DISPONIBLE    /* Las instantaneas se cargan con mmap() */
+#endif
+
+/* Modo concurrente: hilos POSIX y operaciones atomicas __atomic de GCC/Clang */
+#if defined(__ATOMIC_RELAXED) && (defined(__unix__) || defined(__APPLE__))
+#define HILOS_DISPONIBLES
+#include <pthread.h>
+#endif
+
+/* Instrucciones vectoriales disponibles segun las banderas del compilador */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Perfilado de las operaciones (compilar con -DPERFILADO). Sin la bandera
+ * las macros no generan codigo */
+#if defined(PERFILADO)
+#define PERFIL_ENTRAR(operacion) perfil_entrar(operacion)
+#define PERFIL_FIN(operacion) perfil_salir(operacion)
+#define PERFIL_SALIR(operacion, valor) (perfil_salir(operacion), (valor))
+#define PERFIL_CONTAR(contador) ((contador)++)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CICLOS_DISPONIBLES  /* Contador de ciclos del procesador (rdtsc) */
+#endif
+#else
+#define PERFIL_ENTRAR(operacion) ((void)0)
+#define PERFIL_FIN(operacion) ((void)0)
+#define PERFIL_SALIR(operacion, valor) (valor)
+#define PERFIL_CONTAR(contador) ((void)0)
+#endif
+
 /* ==================== ESTRUCTURAS ==================== */
 
 /**
- * Estructura que representa una particion de memoria
+ * Registro de una particion en formato por filas. Es la disposicion
+ * anterior de la tabla; se conserva para medir el recorrido contra la
+ * tabla por columnas
  */
 typedef struct {
     int id;                 /* ID unico de la particion */
@@ -21,466 +68,8641 @@ typedef struct {
     int direccion_inicio;   /* Direccion de inicio en memoria */
     int tamano;             /* Tamano de la particion */
     int estado;             /* 0 = Libre, 1 = Ocupada */
+    int tamano_usado;       /* KB ocupados por el proceso desde el inicio */
+    struct Proceso *proceso; /* Proceso asignado (NULL si esta libre) */
 } Particion;
 
 /**
- * Estructura que representa un proceso (nodo de lista enlazada)
+ * Tabla de particiones por columnas: cada campo en su propio arreglo, de
+ * modo que un recorrido solo trae a la cache los campos que consulta. El
+ * ID de una particion es su posicion y el estado va empaquetado en bits
+ */
+typedef struct {
+    int *direccion_inicio;      /* Direccion de inicio en memoria */
+    int *tamano;                /* Tamano de la particion */
+    int *id_proceso;            /* ID del proceso asignado (-1 si esta libre) */
+    int *tamano_usado;          /* KB ocupados por el proceso desde el inicio */
+    struct Proceso **proceso;   /* Proceso asignado (NULL si esta libre) */
+    unsigned long *ocupadas;    /* Bit i = 1 si la particion i esta ocupada */
+} TablaParticiones;
+
+/**
+ * Estructura que representa un proceso (nodo de lista doblemente enlazada)
  */
 typedef struct Proceso {
     int id;                     /* ID unico del proceso */
     int tamano_requerido;       /* Tamano que requiere el proceso */
     int direccion_asignada;     /* Direccion donde fue asignado */
+    int particion;              /* Indice de la particion que ocupa */
+    int *tabla_paginas;         /* Marco de cada pagina (solo en paginacion) */
     struct Proceso *siguiente;  /* Puntero al siguiente nodo */
+    struct Proceso *anterior;   /* Puntero al nodo anterior */
 } Proceso;
 
+/**
+ * Bloque contiguo de nodos Proceso reservado de una sola vez por el pool
+ */
+typedef struct BloqueProcesos {
+    Proceso *nodos;                     /* Nodos del bloque (tras la cabecera) */
+    int capacidad;                      /* Cantidad de nodos del bloque */
+    struct BloqueProcesos *siguiente;   /* Bloque reservado anteriormente */
+} BloqueProcesos;
+
+/**
+ * Mapa de bits de dos niveles: cada bit de 'palabras' marca un elemento
+ * disponible y cada bit de 'resumen' marca una palabra con algun bit activo,
+ * de modo que la busqueda del primer disponible salta bloques vacios enteros
+ */
+typedef struct {
+    unsigned long *palabras;    /* Bit i = 1 si el elemento i esta disponible */
+    unsigned long *resumen;     /* Bit w = 1 si palabras[w] != 0 */
+    int num_bits;               /* Cantidad de elementos representados */
+    int num_palabras;           /* Longitud de 'palabras' */
+    int num_resumen;            /* Longitud de 'resumen' */
+} MapaBits;
+
+#define BITS_POR_PALABRA ((int)(sizeof(unsigned long) * CHAR_BIT))
+
+/**
+ * Bloque del particionamiento dinamico: un proceso o un hueco contiguo.
+ * Los bloques forman una lista doble por direccion (para fusionar huecos
+ * vecinos) y los huecos ademas una lista doble dentro de su clase de tamano
+ */
+typedef struct {
+    int inicio;             /* Direccion de inicio en memoria */
+    int tamano;             /* Tamano exacto del bloque (KB) */
+    int libre;              /* 1 = hueco, 0 = ocupado por un proceso */
+    int anterior;           /* Bloque vecino de menor direccion (-1 si no hay) */
+    int siguiente;          /* Bloque vecino de mayor direccion (-1 si no hay) */
+    int anterior_clase;     /* Hueco anterior de la misma clase (-1 si no hay) */
+    int siguiente_clase;    /* Hueco siguiente de la misma clase, o siguiente
+                               registro sin uso en la pila de reciclados */
+    struct Proceso *proceso; /* Proceso asignado (NULL si es un hueco) */
+} Bloque;
+
+#define ESQUEMA_PARTICIONES 0   /* Tabla de particiones iguales o variables */
+#define ESQUEMA_DINAMICO 1      /* Bloques a medida tallados de los huecos */
+#define ESQUEMA_BUDDY 2         /* Bloques de potencia de 2 (sistema de companeros) */
+#define ESQUEMA_PAGINACION 3    /* Paginas de tamano fijo en marcos dispersos */
+
+/* Indice segregado de huecos en dos niveles: clase = potencia de 2 del
+ * tamano, subclase = siguientes SUBCLASES_LOG2 bits del tamano */
+#define SUBCLASES_LOG2 4
+#define NUM_SUBCLASES (1 << SUBCLASES_LOG2)
+#define NUM_CLASES 32
+
+/* Ordenes del sistema de companeros: un bloque de orden k mide 2^k KB */
+#define ORDENES_BUDDY 31
+
+/**
+ * Entrada del TLB simulado: traduce una pagina de un proceso a su marco.
+ * El ID del proceso hace de etiqueta de espacio de direcciones, asi que un
+ * cambio de proceso no obliga a vaciar el TLB
+ */
+typedef struct {
+    int proceso;                /* ID del proceso (-1 = entrada invalida) */
+    int pagina;                 /* Pagina virtual */
+    int marco;                  /* Marco fisico */
+    unsigned long uso;          /* Ultimo acceso (LRU dentro del conjunto) */
+} EntradaTLB;
+
+#define TLB_ENTRADAS 64         /* Entradas del TLB por defecto */
+#define TLB_VIAS 4              /* Asociatividad del TLB por defecto */
+#define CUANTO_PAGINACION 1000  /* Referencias seguidas de un proceso (--paginacion) */
+
+#define REEMPLAZO_NINGUNO 0     /* Sin memoria virtual: todas las paginas en marcos */
+#define REEMPLAZO_FIFO 1        /* Sale la pagina cargada hace mas tiempo */
+#define REEMPLAZO_LRU 2         /* Sale la pagina usada hace mas tiempo */
+#define REEMPLAZO_RELOJ 3       /* Segunda oportunidad con bits de referencia */
+#define REEMPLAZO_ARC 4         /* Cache de reemplazo adaptable (recencia y frecuencia) */
+#define NUM_REEMPLAZOS 5
+
+/* Listas del directorio de paginas. FIFO y LRU solo usan LISTA_T1 */
+#define LISTA_T1 0              /* Residentes vistas una vez (ARC) */
+#define LISTA_T2 1              /* Residentes vistas mas de una vez (ARC) */
+#define LISTA_B1 2              /* Fantasmas desalojadas de T1 (ARC) */
+#define LISTA_B2 3              /* Fantasmas desalojadas de T2 (ARC) */
+#define NUM_LISTAS 4
+#define TAMANO_LECTURA 1048576  /* Bytes leidos de una vez de una traza de referencias */
+
+/**
+ * Pagina del directorio de reemplazo. La entrada i < num_marcos es la
+ * pagina cargada en el marco i; las siguientes son las fantasmas de ARC
+ * (solo la clave) y las ultimas, los centinelas de las listas. Las listas
+ * son dobles y circulares, del extremo menos reciente al mas reciente
+ */
+typedef struct {
+    int proceso;                /* Proceso duenio (-1 = entrada sin uso) */
+    long pagina;                /* Pagina virtual */
+    int lista;                  /* LISTA_T1 .. LISTA_B2 (-1 = en ninguna) */
+    int anterior;               /* Vecina menos reciente */
+    int siguiente;              /* Vecina mas reciente */
+    int siguiente_hash;         /* Siguiente entrada de la misma cubeta, o
+                                   siguiente fantasma libre */
+} EntradaPagina;
+
+/**
+ * Proceso en espera de memoria: ya tiene ID pero aun no esta cargado
+ */
+typedef struct Pendiente {
+    int id;                     /* ID reservado al llegar */
+    int tamano;                 /* Tamano requerido (KB) */
+    int prioridad;              /* 1 (baja) .. PRIORIDAD_MAXIMA (alta) */
+    long llegada;               /* Instante de llegada (reloj de operaciones) */
+    int ranura;                 /* Posicion en cola_ranuras (orden de llegada) */
+    int en_monticulo;           /* Posicion en el monticulo por prioridad */
+    struct Pendiente *siguiente; /* Siguiente de su cubeta del indice, o del pool */
+} Pendiente;
+
+/**
+ * Bloque contiguo de nodos Pendiente reservado de una sola vez por su pool
+ */
+typedef struct BloquePendientes {
+    Pendiente *nodos;                   /* Nodos del bloque (tras la cabecera) */
+    int capacidad;                      /* Cantidad de nodos del bloque */
+    struct BloquePendientes *siguiente; /* Bloque reservado anteriormente */
+} BloquePendientes;
+
+#define COLA_DESACTIVADA 0      /* Los procesos que no caben se descartan */
+#define COLA_FIFO 1             /* Se atiende siempre al primero en llegar */
+#define COLA_TAMANO 2           /* Se atiende al primero que quepa */
+#define COLA_PRIORIDAD 3        /* Se atiende al de mayor prioridad */
+#define PRIORIDAD_MAXIMA 5
+#define PROCESO_EN_COLA (-3)    /* asignacion diferida: el proceso espera */
+
+/**
+ * Proceso terminado (historial de cierres, como en Practica1.c)
+ */
+typedef struct {
+    int id;                     /* ID del proceso */
+    int tamano;                 /* Tamano que requeria (KB) */
+    int direccion;              /* Direccion donde estaba asignado */
+} Terminado;
+
+/**
+ * Estadisticas de uso de la memoria, actualizadas en O(1) en cada carga y
+ * liberacion de un proceso para que consultarlas no recorra la tabla
+ */
+typedef struct {
+    int procesos;               /* Procesos en memoria (particiones o bloques ocupados) */
+    long kb_usados;             /* KB pedidos por los procesos en memoria */
+    long kb_asignados;          /* KB reservados para ellos (particion o bloque entero) */
+    double suma_fragmentacion;  /* Suma de la fragmentacion interna (%) de cada uno */
+    long admitidos;             /* Procesos cargados desde la configuracion */
+    long histograma[NUM_CLASES]; /* Admitidos por tamano: clase k = 2^k .. 2^(k+1)-1 KB */
+} Estadisticas;
+
+#define TAMANO_SALIDA 65536     /* Bytes del bufer de la vista de memoria */
+#define CELDAS_POR_LINEA 20     /* Celdas por linea de la vista de celdas */
+#define VISTA_CELDAS 0          /* Una celda por KB */
+#define VISTA_TRAMOS 1          /* Una linea por tramo de celdas iguales */
+#define VISTA_MAPA 2            /* Un caracter por cada 'escala_mapa' KB */
+#define CARACTERES_MAPA 64      /* Caracteres por linea del mapa */
+#define LINEAS_MAPA 16          /* Lineas del mapa con escala automatica */
+
+#define FORMATO_JSON 0           /* Un documento con las tablas pedidas */
+#define FORMATO_CSV 1            /* Una tabla por archivo, con cabecera */
+#define EXPORTAR_TODAS 0         /* Todas las tablas (solo JSON) */
+#define EXPORTAR_PROCESOS 1
+#define EXPORTAR_PARTICIONES 2   /* Particiones, bloques o marcos segun el motor */
+#define EXPORTAR_TERMINADOS 3
+#define EXPORTAR_ESTADISTICAS 4  /* Una sola fila con los agregados */
+#define EXPORTAR_HISTOGRAMA 5
+#define NUM_EXPORTACIONES 6
+
+#define MAGIA_INSTANTANEA "TSOINST"
+#define VERSION_INSTANTANEA 1
+#define ORDEN_BYTES_INSTANTANEA 0x01020304
+
+/**
+ * Cabecera de una instantanea binaria del estado. Tras ella van las
+ * secciones en los desplazamientos indicados, alineadas a 8 bytes y en el
+ * formato nativo de la maquina, de modo que el archivo mapeado se usa en
+ * su lugar: las columnas de la tabla y el historial apuntan dentro de el.
+ * La cabecera registra el orden de bytes y los tamanos de los tipos para
+ * rechazar archivos de otra arquitectura
+ */
+typedef struct {
+    char magia[8];              /* MAGIA_INSTANTANEA */
+    int version;                /* VERSION_INSTANTANEA */
+    int orden_bytes;            /* ORDEN_BYTES_INSTANTANEA en formato nativo */
+    int bytes_long;             /* sizeof(long) */
+    int bytes_cabecera;         /* sizeof(CabeceraInstantanea) */
+    int num_particiones;
+    int tamano_total_memoria;
+    int tamano_particion;
+    int particiones_variables;
+    int politica;               /* Indice en politicas[] */
+    int ultima_asignada;
+    int contador_procesos;
+    int num_procesos;
+    int politica_cola;
+    int capacidad_cola;
+    int longitud_cola;
+    int cola_profundidad_maxima;
+    unsigned long estado_aleatorio;
+    long reloj_operaciones;
+    long num_terminados;
+    long cola_encolados;
+    long cola_atendidos;
+    long cola_rechazados;
+    long cola_cancelados;
+    long cola_espera_total;
+    long cola_espera_maxima;
+    double cola_profundidad_acumulada;
+    Estadisticas estadisticas;
+    long tamano_archivo;        /* Bytes totales (detecta archivos truncados) */
+    long desp_direcciones;      /* int[num_particiones] */
+    long desp_tamanos;          /* int[num_particiones] */
+    long desp_ids;              /* int[num_particiones] */
+    long desp_usados;           /* int[num_particiones] */
+    long desp_ocupadas;         /* unsigned long[palabras de num_particiones bits] */
+    long desp_procesos;         /* RegistroProceso[num_procesos], orden de creacion */
+    long desp_terminados;       /* Terminado[num_terminados] */
+    long desp_pendientes;       /* RegistroPendiente[longitud_cola], orden de llegada */
+} CabeceraInstantanea;
+
+/**
+ * Proceso en memoria dentro de una instantanea
+ */
+typedef struct {
+    int id;
+    int tamano;
+    int direccion;
+    int particion;
+} RegistroProceso;
+
+/**
+ * Proceso en espera dentro de una instantanea
+ */
+typedef struct {
+    int id;
+    int tamano;
+    int prioridad;
+    long llegada;
+} RegistroPendiente;
+
+/**
+ * Evento de la simulacion de eventos discretos
+ */
+typedef struct {
+    double tiempo;              /* Instante virtual del evento */
+    int tipo;                   /* EVENTO_SALIDA o EVENTO_LLEGADA */
+    int id;                     /* Proceso que termina (salidas) */
+    long secuencia;             /* Desempate: orden de creacion del evento */
+} Evento;
+
+#define EVENTO_SALIDA 0         /* A igual tiempo, las salidas van primero */
+#define EVENTO_LLEGADA 1
+
+#define CONCURRENCIA_CAS 0      /* Cada hilo reclama en la tabla con CAS */
+#define CONCURRENCIA_ALMACEN 1  /* Cada hilo asigna desde su propio almacen */
+#define TAMANO_ALMACEN 64       /* Particiones libres que guarda un hilo */
+#define LOTE_ALMACEN 32         /* Particiones por recarga o devolucion */
+#define LINEA_CACHE 64          /* Bytes de una linea de cache */
+
+/**
+ * Parametros y resultados de un hilo del modo concurrente
+ */
+typedef struct {
+    long operaciones;           /* Creaciones y cierres a realizar */
+    int limite;                 /* Maximo de particiones propias a la vez */
+    int modo;                   /* CONCURRENCIA_CAS o CONCURRENCIA_ALMACEN */
+    int indice;                 /* Posicion del hilo (para elegir victimas) */
+    unsigned long semilla;      /* Estado propio del generador */
+    int *propias;               /* Particiones reclamadas por este hilo */
+    int num_propias;            /* Particiones que conserva al terminar */
+    long creados;               /* Particiones reclamadas */
+    long cerrados;              /* Particiones devueltas */
+    long reintentos;            /* CAS perdidos, o recargas sin exito */
+    long robos;                 /* Recargas tomadas del almacen de otro hilo */
+    int almacen[TAMANO_ALMACEN]; /* Particiones libres reservadas por el hilo */
+    int en_almacen;             /* Particiones en el almacen */
+#if defined(HILOS_DISPONIBLES)
+    pthread_mutex_t cerrojo;    /* Protege el almacen (solo hay disputa al robar) */
+#endif
+    char relleno[LINEA_CACHE];  /* En un arreglo alineado a LINEA_CACHE, deja al
+                                 * menos una linea entre los datos de hilos vecinos */
+} TrabajoHilo;
+
+/**
+ * Estado y datos de una particion en el modo concurrente, uno por linea de
+ * cache: en las columnas de la tabla 16 particiones comparten linea, y en
+ * el mapa de ocupadas 64 comparten palabra, asi que hilos con particiones
+ * vecinas se invalidarian la linea entre si. Se vuelcan a la tabla al
+ * terminar
+ */
+typedef struct {
+    int estado;                 /* 0 = libre, 1 = reclamada (se cambia con CAS) */
+    int id_proceso;
+    int tamano_usado;
+    char relleno[LINEA_CACHE - 3 * sizeof(int)];
+} RanuraConcurrente;
+
+/**
+ * Politica de ubicacion: elige la particion libre para un proceso
+ */
+typedef struct {
+    const char *nombre;             /* Nombre usado en menus y trazas */
+    const char *descripcion;        /* Nombre para mostrar */
+    int (*buscar)(int tamano);      /* Indice de particion libre o -1 */
+} PoliticaUbicacion;
+
+#define PERFIL_CREAR 0            /* solicitar_proceso(): crear o encolar */
+#define PERFIL_CERRAR 1           /* terminar_proceso(): cerrar y drenar la cola */
+#define PERFIL_ADMITIR 2          /* admitir_proceso(): asignar con el motor */
+#define PERFIL_LIBERAR 3          /* liberar_proceso(): liberar con el motor */
+#define PERFIL_BUSCAR 4           /* buscar_proceso(): busqueda por ID */
+#define PERFIL_COMPACTAR 5        /* compactar_memoria() */
+#define PERFIL_TABLA_PROCESOS 6   /* mostrar_tabla_procesos() */
+#define PERFIL_TABLA_PARTICIONES 7 /* Tabla de particiones, bloques o paginas */
+#define PERFIL_VISTA_MEMORIA 8    /* recorrer_memoria(): las tres vistas */
+#define PERFIL_TERMINADOS 9       /* mostrar_procesos_terminados() */
+#define PERFIL_ESTADISTICAS 10    /* mostrar_estadisticas() */
+#define NUM_PERFILES 11
+
+#if defined(PERFILADO)
+/**
+ * Mediciones acumuladas de una operacion. 'revisados' y 'nodos' son lo que
+ * avanzaron los contadores globales durante cada llamada (incluidas las
+ * operaciones anidadas)
+ */
+typedef struct {
+    long llamadas;              /* Llamadas terminadas */
+    double ns_total;            /* Tiempo total */
+    double ns_maximo;           /* Llamada mas lenta */
+    double ciclos_total;        /* Ciclos totales (si hay contador de ciclos) */
+    long revisados;             /* Candidatos revisados por las busquedas */
+    long revisados_maximo;      /* Mayor cantidad en una llamada */
+    long nodos;                 /* Ranuras y nodos recorridos en busquedas por ID */
+    long nodos_maximo;          /* Mayor cantidad en una llamada */
+    double inicio_ns;           /* Inicio de la llamada en curso */
+    unsigned long inicio_ciclos; /* Ciclos al inicio de la llamada en curso */
+    long inicio_revisados;      /* perfil_revisados al inicio */
+    long inicio_nodos;          /* perfil_nodos al inicio */
+} MedicionPerfil;
+#endif
+
 /* ==================== VARIABLES GLOBALES ==================== */
 
-int *memoria = NULL;              /* Vector que simula la RAM */
-Particion *tabla_particiones = NULL;  /* Arreglo de particiones */
+const char *nombres_cola[] = { "ninguna", "fifo", "tamano", "prioridad" };
+
+int *memoria = NULL;              /* Vector que simula la RAM (NULL si es compacta) */
+int memoria_compacta = 0;         /* 1 = sin vector por KB, solo extensiones */
+TablaParticiones tabla_particiones = { NULL, NULL, NULL, NULL, NULL, NULL }; /* Particiones */
 Proceso *lista_procesos = NULL;   /* Lista enlazada de procesos */
+Proceso *ultimo_proceso = NULL;   /* Ultimo nodo de la lista (orden de creacion) */
+Proceso **indice_procesos = NULL; /* Tabla hash (sondeo lineal) de procesos por ID */
+int capacidad_indice = 0;         /* Ranuras de la tabla hash (potencia de 2) */
+int procesos_en_indice = 0;       /* Ranuras ocupadas de la tabla hash */
+BloqueProcesos *bloques_procesos = NULL; /* Bloques de nodos del pool */
+Proceso *nodos_libres = NULL;     /* Nodos reciclados, enlazados por 'siguiente' */
+int capacidad_pool = 0;           /* Total de nodos reservados en el pool */
 int num_particiones = 0;          /* Numero total de particiones */
 int tamano_total_memoria = 0;     /* Tamano total de memoria */
 int tamano_particion = 0;         /* Tamano de cada particion */
 int contador_procesos = 1;        /* Contador para asignar IDs a procesos */
+MapaBits mapa_libres;             /* Indice de particiones libres (bit = estado 0) */
+int particiones_variables = 0;    /* 1 = particiones de tamanos distintos */
+int *orden_por_tamano = NULL;     /* Particiones ordenadas por (tamano, indice) */
+int *rango_por_tamano = NULL;     /* Posicion de cada particion en ese orden */
+int *tamanos_ordenados = NULL;    /* Tamano de la particion en cada posicion */
+MapaBits mapa_por_tamano;         /* Bit k = 1 si orden_por_tamano[k] esta libre */
+int *arbol_libres = NULL;         /* Arbol de maximos: mayor particion libre por rango */
+int hojas_arbol = 0;              /* Hojas del arbol (potencia de 2 >= particiones) */
+int ultima_asignada = -1;         /* Ultima particion asignada (Siguiente Ajuste) */
+const PoliticaUbicacion *politica_actual = NULL; /* Politica de ubicacion activa */
+int esquema_memoria = ESQUEMA_PARTICIONES; /* Motor de asignacion activo */
+Bloque *bloques = NULL;           /* Registros de bloques del modo dinamico */
+int capacidad_bloques = 0;        /* Registros reservados en 'bloques' */
+int bloques_sin_uso = -1;         /* Pila de registros reciclables */
+int num_bloques = 0;              /* Bloques vigentes (huecos + ocupados) */
+int num_huecos = 0;               /* Bloques libres */
+int memoria_libre = 0;            /* KB libres en huecos */
+double umbral_compactacion = 0.0; /* Fragmentacion externa (%) que dispara la compactacion (0 = nunca) */
+long compactaciones = 0;          /* Pasadas de compactacion */
+long compactaciones_automaticas = 0; /* Pasadas disparadas por el umbral */
+long kb_compactados = 0;          /* KB reubicados en todas las pasadas */
+double ns_compactacion = 0.0;     /* Tiempo total compactando */
+double ns_ultima_compactacion = 0.0; /* Tiempo de la ultima pasada */
+int cabeza_clase[NUM_CLASES][NUM_SUBCLASES]; /* Primer hueco de cada subclase */
+unsigned long mapa_clases = 0;    /* Bit c = 1 si la clase c tiene huecos */
+unsigned long mapa_subclases[NUM_CLASES]; /* Bit s = 1 si la subclase s tiene huecos */
+MapaBits buddy_libres[ORDENES_BUDDY];    /* Bit i de orden k: bloque libre en i * 2^k */
+MapaBits buddy_ocupados[ORDENES_BUDDY];  /* Bit i de orden k: bloque asignado en i * 2^k */
+int buddy_num_libres[ORDENES_BUDDY];     /* Bloques libres de cada orden */
+unsigned long ordenes_libres = 0;        /* Bit k = 1 si hay bloques libres de orden k */
+long buddy_asignado = 0;                 /* KB en bloques asignados (incluye el redondeo) */
+long buddy_usado = 0;                    /* KB pedidos por los procesos */
+int tamano_pagina = 0;                   /* KB de cada pagina y de cada marco */
+int num_marcos = 0;                      /* Marcos de pagina de la memoria */
+int *marcos_libres = NULL;               /* Pila de marcos libres */
+int num_marcos_libres = 0;               /* Marcos en la pila */
+int *marco_proceso = NULL;               /* ID del proceso de cada marco (-1 = libre) */
+int *marco_usado = NULL;                 /* KB usados de cada marco */
+long entradas_tablas = 0;                /* Entradas de todas las tablas de paginas */
+EntradaTLB *tlb = NULL;                  /* Entradas del TLB, por conjuntos de 'tlb_vias' */
+int tlb_entradas = TLB_ENTRADAS;         /* Entradas totales del TLB */
+int tlb_vias = TLB_VIAS;                 /* Entradas por conjunto */
+int tlb_conjuntos = 0;                   /* tlb_entradas / tlb_vias */
+unsigned long tlb_reloj = 0;             /* Accesos al TLB (marca de uso) */
+long tlb_aciertos = 0;                   /* Traducciones resueltas por el TLB */
+long tlb_fallos = 0;                     /* Traducciones que recorrieron la tabla */
+long referencias_invalidas = 0;          /* Direcciones fuera de un proceso */
+const char *nombres_reemplazo[] = { "ninguno", "fifo", "lru", "reloj", "arc" };
+int politica_reemplazo = REEMPLAZO_NINGUNO; /* Memoria virtual y su politica */
+EntradaPagina *directorio = NULL;        /* Paginas residentes, fantasmas y centinelas */
+int entradas_directorio = 0;             /* Entradas antes de los centinelas */
+int *cubetas = NULL;                     /* Primera entrada de cada cubeta (-1 = vacia) */
+unsigned long mascara_cubetas = 0;       /* Cubetas - 1 (potencia de 2) */
+int fantasmas_libres = -1;               /* Pila de entradas fantasma sin uso */
+int largo_lista[NUM_LISTAS];             /* Entradas en cada lista */
+long objetivo_t1 = 0;                    /* Tamano deseado de T1 (p de ARC) */
+unsigned long *bits_referencia = NULL;   /* Bit m = 1 si el marco m fue referenciado */
+int manecilla = 0;                       /* Proximo marco que revisa el reloj */
+long fallos_pagina = 0;                  /* Referencias a paginas no residentes */
+long desalojos = 0;                      /* Paginas sacadas de un marco */
+int politica_cola = COLA_DESACTIVADA;    /* Politica de la cola de espera */
+int capacidad_cola = 0;                  /* Maximo de procesos en espera (0 = sin limite) */
+Pendiente **cola_ranuras = NULL;         /* En espera por orden de llegada (NULL = vacia) */
+int *arbol_cola = NULL;                  /* Arbol de minimos del tamano por ranura */
+int hojas_cola = 0;                      /* Ranuras (potencia de 2) */
+int ranuras_usadas = 0;                  /* Proxima ranura a asignar */
+int cabeza_cola = 0;                     /* Las ranuras anteriores estan vacias */
+Pendiente **monticulo_cola = NULL;       /* Monticulo por prioridad y llegada */
+int capacidad_monticulo = 0;             /* Lugares en 'monticulo_cola' */
+int monticulo_al_dia = 1;                /* Solo se mantiene con COLA_PRIORIDAD */
+Pendiente **indice_cola = NULL;          /* Indice por ID, encadenado por cubetas */
+int cubetas_cola = 0;                    /* Cubetas del indice (potencia de 2) */
+BloquePendientes *bloques_pendientes = NULL; /* Bloques del pool de la cola */
+Pendiente *pendientes_libres = NULL;     /* Nodos de la cola disponibles */
+int longitud_cola = 0;                   /* Procesos en espera */
+long reloj_operaciones = 0;              /* Creaciones y cierres solicitados */
+long cola_encolados = 0;                 /* Procesos que entraron a la cola */
+long cola_atendidos = 0;                 /* Procesos admitidos desde la cola */
+long cola_rechazados = 0;                /* Procesos descartados (cola llena o demasiado grandes) */
+long cola_cancelados = 0;                /* Procesos cerrados mientras esperaban */
+long cola_espera_total = 0;              /* Suma de esperas de los atendidos */
+long cola_espera_maxima = 0;             /* Mayor espera de un atendido */
+int cola_profundidad_maxima = 0;         /* Mayor longitud alcanzada */
+double cola_profundidad_acumulada = 0.0; /* Suma de la longitud en cada operacion */
+void (*al_admitir_desde_cola)(int id_proceso) = NULL; /* Aviso de admision diferida */
+TrabajoHilo *trabajos_hilos = NULL;      /* Hilos de la medicion concurrente */
+int num_trabajos_hilos = 0;              /* Hilos en 'trabajos_hilos' */
+int *deposito = NULL;                    /* Particiones libres fuera de los almacenes */
+RanuraConcurrente *ranuras = NULL;       /* Una por particion, alineadas a LINEA_CACHE */
+int en_deposito = 0;                     /* Particiones en el deposito */
+#if defined(HILOS_DISPONIBLES)
+pthread_mutex_t cerrojo_deposito = PTHREAD_MUTEX_INITIALIZER; /* Protege el deposito */
+#endif
+Evento *eventos = NULL;                  /* Monticulo minimo de eventos */
+int num_eventos = 0;                     /* Eventos pendientes */
+int capacidad_eventos = 0;               /* Eventos reservados */
+long secuencia_eventos = 0;              /* Eventos creados (desempate) */
+double tiempo_virtual = 0.0;             /* Reloj de la simulacion */
+double *llegada_sim = NULL;              /* Instante de llegada por ID de proceso */
+double *duracion_sim = NULL;             /* Duracion muestreada por ID de proceso */
+int capacidad_sim = 0;                   /* IDs con espacio en los dos arreglos */
+double sim_kb_en_uso = 0.0;              /* KB pedidos por los procesos en memoria */
+double sim_espera_total = 0.0;           /* Suma de esperas virtuales de los admitidos */
+double sim_espera_maxima = 0.0;          /* Mayor espera virtual */
+long sim_admitidos = 0;                  /* Procesos que entraron en memoria */
+long sim_admitidos_cola = 0;             /* Admitidos tras esperar en la cola */
+Estadisticas estadisticas;               /* Uso de la memoria (todo en 0 al configurar) */
+Terminado *terminados = NULL;            /* Historial de procesos cerrados */
+long num_terminados = 0;                 /* Procesos en el historial */
+long capacidad_terminados = 0;           /* Registros reservados en 'terminados' */
+int guardar_terminados = 1;              /* 0 = no registrar cierres (prueba de rendimiento) */
+char bufer_salida[TAMANO_SALIDA];        /* Texto de la vista de memoria sin escribir */
+int en_salida = 0;                       /* Bytes ocupados de 'bufer_salida' */
+FILE *archivo_salida = NULL;             /* Destino de 'bufer_salida' (NULL = stdout) */
+int error_salida = 0;                    /* 1 si fallo alguna escritura del bufer */
+const char *nombres_esquema[] = { "particiones", "dinamico", "buddy", "paginacion" };
+const char *nombres_exportacion[] = {
+    "todas", "procesos", "particiones", "terminados", "estadisticas", "histograma"
+};
+int formato_exportacion = FORMATO_JSON;  /* Formato de la exportacion en curso */
+int tablas_exportadas = 0;               /* Tablas escritas en el documento JSON */
+long filas_exportadas = 0;               /* Filas escritas en la tabla en curso */
+int campos_exportados = 0;               /* Campos escritos en la fila en curso */
+int tabla_es_objeto = 0;                 /* 1 = la tabla JSON es un solo objeto */
+int vista_memoria = VISTA_CELDAS;        /* Formato de recorrer_memoria() */
+long celdas_emitidas = 0;                /* Celdas emitidas (saltos de linea) */
+int tramo_valor = -1;                    /* Contenido del tramo en curso */
+long tramo_inicio = 0;                   /* Direccion de inicio del tramo en curso */
+long tramo_largo = 0;                    /* KB del tramo en curso (0 = ninguno) */
+long escala_mapa = 1;                    /* KB representados por cada caracter del mapa */
+long mapa_ocupado = 0;                   /* KB ocupados del caracter en curso */
+char *instantanea = NULL;                /* Instantanea cargada (mapeada o leida) */
+size_t tamano_instantanea = 0;           /* Bytes de la instantanea cargada */
+int tabla_en_instantanea = 0;            /* 1 = columnas de la tabla dentro de ella */
+int terminados_en_instantanea = 0;       /* 1 = historial dentro de ella */
+unsigned long estado_aleatorio = 1; /* Estado del generador xorshift (nunca 0) */
+#if defined(PERFILADO)
+const char *nombres_perfil[] = {
+    "crear proceso", "cerrar proceso", "asignar memoria", "liberar memoria",
+    "buscar por ID", "compactar", "tabla de procesos", "tabla de particiones",
+    "vista de memoria", "terminados", "estadisticas"
+};
+MedicionPerfil perfil[NUM_PERFILES];     /* Mediciones por operacion */
+long perfil_revisados = 0;               /* Palabras de mapas, nodos de arbol y huecos revisados */
+long perfil_nodos = 0;                   /* Ranuras del indice y nodos de la cola recorridos */
+#endif
 
 /* ==================== PROTOTIPOS DE FUNCIONES ==================== */
 
-void agregar_proceso(int id, int tamano, int direccion);
+void semilla_aleatoria(unsigned long semilla);
+unsigned long aleatorio_de(unsigned long *estado);
+unsigned long siguiente_aleatorio(void);
+int aleatorio_entre(int minimo, int maximo);
+double tiempo_ns(void);
+void llenar_celdas(int *destino, int cantidad, int valor);
+#if defined(PERFILADO)
+unsigned long leer_ciclos(void);
+void perfil_entrar(int operacion);
+void perfil_salir(int operacion);
+void mostrar_perfil(void);
+#endif
+int primer_bit(unsigned long palabra);
+int mapa_crear(MapaBits *mapa, int num_bits);
+void mapa_destruir(MapaBits *mapa);
+void mapa_limpiar(MapaBits *mapa);
+int mapa_consultar(const MapaBits *mapa, int indice);
+void mapa_activar(MapaBits *mapa, int indice);
+void mapa_desactivar(MapaBits *mapa, int indice);
+int mapa_buscar_desde(const MapaBits *mapa, int desde);
+int ultimo_bit(unsigned long palabra);
+int mapa_buscar_ultimo(const MapaBits *mapa);
+int pool_crecer(int cantidad);
+Proceso* pool_obtener(void);
+void pool_devolver(Proceso *nodo);
+void pool_destruir(void);
+unsigned long hash_proceso(int id);
+int indice_insertar(Proceso *proceso);
+Proceso* indice_extraer(int id);
+Proceso* agregar_proceso(int id, int tamano, int direccion, int particion);
 int eliminar_proceso(int id);
 Proceso* buscar_proceso(int id);
+int comparar_por_tamano(const void *a, const void *b);
+int construir_indices_variables(void);
+void arbol_actualizar(int indice, int valor);
+int arbol_buscar(int nodo, int izq, int der, int desde, int tamano);
+int primera_por_tamano(int tamano);
+int buscar_primer_ajuste(int tamano);
+int buscar_mejor_ajuste(int tamano);
+int buscar_peor_ajuste(int tamano);
+int buscar_siguiente_ajuste(int tamano);
+const PoliticaUbicacion* buscar_politica(const char *nombre);
+int estado_particion(int indice);
+void ocupar_particion(int indice);
+void desocupar_particion(int indice);
+void clase_de_tamano(int tamano, int *clase, int *subclase);
+void hueco_insertar(int bloque);
+void hueco_quitar(int bloque);
+int bloque_nuevo(void);
+void bloque_reciclar(int bloque);
+int buscar_hueco(int tamano);
+int tallar_bloque(int hueco, int tamano);
+int liberar_bloque(int bloque);
+int mayor_hueco(void);
+float fragmentacion_externa(void);
+float fragmentacion_interna_total(void);
+void configurar_dinamica(int total, int maximo_proceso);
+int asignar_dinamico(int id_proceso, int tamano_proceso);
+long mover_tramo(long origen, long destino, long largo);
+long compactar_dinamico(void);
+long compactar_particiones(void);
+long compactar_memoria(void);
+void mostrar_metricas_compactacion(void);
+void compactar_interactivo(void);
+int orden_buddy(int tamano);
+void buddy_marcar_libre(int direccion, int orden);
+void buddy_quitar_libre(int direccion, int orden);
+int buddy_liberar_bloque(int direccion, int orden);
+void configurar_buddy(int total, int maximo_proceso);
+int asignar_buddy(int id_proceso, int tamano_proceso);
+int liberar_buddy(Proceso *proceso);
+int mayor_bloque_buddy(void);
+int bloque_buddy_en(int direccion, int *orden);
+int comparar_por_direccion(const void *a, const void *b);
+void configurar_paginacion(int total, int pagina, int maximo_proceso);
+int configurar_tlb(int entradas, int vias);
+int asignar_paginado(int id_proceso, int tamano_proceso);
+int liberar_paginado(Proceso *proceso);
+void tlb_invalidar_proceso(int id_proceso);
+void tlb_invalidar_pagina(int id_proceso, int pagina);
+int marco_de_pagina(Proceso *proceso, int pagina);
+int traducir_direccion(int id_proceso, long direccion, long *fisica);
+int buscar_reemplazo(const char *nombre);
+int reemplazo_configurar(int politica);
+void reemplazo_destruir(void);
+unsigned long hash_pagina(int proceso, long pagina);
+int pagina_buscar(int proceso, long pagina);
+void pagina_hash_insertar(int entrada);
+void pagina_hash_quitar(int entrada);
+void lista_quitar(int entrada);
+void lista_agregar(int entrada, int lista);
+void reemplazo_acceso(int marco);
+void reemplazo_olvidar(int lista);
+int reemplazo_desalojar(int hacia_b2);
+int reemplazo_fallo(int proceso, long pagina);
+void reemplazo_soltar(int marco);
+int referenciar_pagina(int proceso, long pagina);
+Proceso **procesos_por_direccion(void);
+int crear_tabla_particiones(int cantidad);
+void destruir_tabla_particiones(void);
+void reservar_vector_memoria(void);
+void reservar_tabla(void);
+void configurar_memoria(int total, int particion);
+void configurar_particiones_variables(int cantidad, const int *tamanos);
+void seleccionar_politica(void);
 void inicializar_memoria(void);
 float calcular_fragmentacion(int tamano_particion, int tamano_proceso);
+void estadisticas_admitir(int tamano_proceso, int tamano_asignado);
+void estadisticas_cargar(int tamano_proceso, int tamano_asignado);
+void estadisticas_retirar(int tamano_proceso, int tamano_asignado);
+void estadisticas_liberar(int tamano_proceso, int tamano_asignado);
+void estadisticas_marco(int usado, int signo);
+void mostrar_estadisticas(void);
+void agregar_proceso_terminado(int id, int tamano, int direccion);
+void mostrar_procesos_terminados(void);
+int asignar_proceso(int tamano_proceso);
+int admitir_proceso(int id_proceso, int tamano_proceso);
+int liberar_proceso(int id_proceso);
+int tamano_maximo_admisible(void);
+void avanzar_reloj(void);
+int pendientes_crecer(int cantidad);
+void arbol_cola_actualizar(int ranura, int valor);
+int arbol_cola_buscar(int nodo, int izq, int der, int desde, int limite);
+int reubicar_ranuras(void);
+int pendiente_antes(const Pendiente *a, const Pendiente *b);
+void monticulo_colocar(Pendiente *pendiente, int posicion);
+void monticulo_subir(int posicion);
+void monticulo_bajar(int posicion);
+void preparar_monticulo(void);
+int agrandar_indice_cola(void);
+Pendiente* buscar_pendiente(int id_proceso);
+Pendiente* primero_de_cola(void);
+int comparar_pendientes(const void *a, const void *b);
+int encolar_proceso(int id_proceso, int tamano, int prioridad);
+void quitar_de_cola(Pendiente *pendiente);
+int cancelar_pendiente(int id_proceso);
+int drenar_cola(int informar);
+int solicitar_proceso(int tamano_proceso, int prioridad);
+int terminar_proceso(int id_proceso, int informar);
+void seleccionar_cola(void);
+void mostrar_cola(void);
+void mostrar_metricas_cola(void);
+void vaciar_cola(void);
+double logaritmo_natural(double x);
+double muestra_exponencial(double media);
+int evento_agregar(double tiempo, int tipo, int id_proceso);
+Evento evento_extraer(void);
+int sim_registrar(int id_proceso, double llegada, double duracion);
+void sim_admitido(int id_proceso);
+int sim_leer_llegada(FILE *traza, double *tiempo, int *tamano, double *duracion);
+int ejecutar_simulacion(int argc, char *argv[]);
 void crear_proceso(void);
 void cerrar_proceso(void);
 void mostrar_tabla_procesos(void);
+void mostrar_tabla_bloques(void);
+void mostrar_tabla_buddy(void);
+void mostrar_tabla_paginas(void);
+void mostrar_metricas_paginacion(void);
+void traducir_interactivo(void);
 void mostrar_tabla_particiones(void);
+void salida_vaciar(void);
+void salida_texto(const char *texto, int largo);
+int formatear_entero(char *destino, long valor, int ancho);
+void salida_entero(long valor, int ancho);
+void salida_cadena(const char *texto);
+void salida_decimal(double valor);
+void agregar_tramo(int valor, long cantidad);
+void cerrar_tramo(void);
+void emitir_caracter_mapa(long ancho);
+void recorrer_memoria(void);
 void mostrar_memoria(void);
+void mostrar_memoria_tramos(void);
+void mostrar_mapa_memoria(void);
+void destruir_estado(void);
 void liberar_recursos(void);
+long alinear_instantanea(long desplazamiento);
+int escribir_relleno(FILE *archivo, long bytes);
+int guardar_instantanea(const char *ruta);
+int validar_contenido_instantanea(const char *datos);
+int cargar_instantanea(const char *ruta);
+void liberar_instantanea(void);
+void guardar_estado(void);
+int buscar_exportacion(const char *nombre);
+long kb_asignados_proceso(const Proceso *proceso);
+void exportar_inicio_tabla(const char *nombre, const char *cabecera, int objeto);
+void exportar_fin_tabla(void);
+void exportar_inicio_fila(void);
+void exportar_fin_fila(void);
+void exportar_nombre(const char *nombre);
+void exportar_entero(const char *nombre, long valor);
+void exportar_decimal(const char *nombre, double valor);
+void exportar_cadena(const char *nombre, const char *valor);
+void exportar_fila_particion(long particion, long inicio, long tamano, int id_proceso,
+                             long usado);
+void exportar_procesos(void);
+void exportar_particiones(void);
+void exportar_terminados(void);
+void exportar_estadisticas(void);
+void exportar_histograma(void);
+int exportar_metricas(const char *ruta, int formato, int tabla);
+void exportar_interactivo(void);
+int ejecutar_lote(const char *ruta);
+int comparar_latencias(const void *a, const void *b);
+unsigned long percentil(unsigned long *muestras, long cantidad, double fraccion);
+void medir_carga(const char *carga, int particiones, long operaciones, double ocupacion,
+                 int variables, int esquema);
+void medir_recorrido(int particiones);
+int ejecutar_benchmark(int argc, char *argv[]);
+void *reservar_alineado(size_t bytes, void **bloque);
+int reclamar_particion(int desde, long *reintentos);
+void tomar_particion(int particion);
+void soltar_particion(int particion);
+int mover_particiones(int *origen, int *en_origen, int *destino, int *en_destino,
+                      int cantidad);
+int recargar_almacen(TrabajoHilo *trabajo);
+int obtener_de_almacen(TrabajoHilo *trabajo);
+void devolver_a_almacen(TrabajoHilo *trabajo, int particion);
+void *trabajador_concurrente(void *argumento);
+int medir_concurrencia(int modo, int hilos, int particiones, long operaciones,
+                       double ocupacion, unsigned long semilla, double *ops_por_segundo,
+                       long *reintentos, long *robos);
+int ejecutar_concurrente(int argc, char *argv[]);
+void medir_paginacion(const char *carga, int total, int pagina, int procesos,
+                      long referencias, int maximo_proceso, unsigned long semilla);
+int ejecutar_paginacion(int argc, char *argv[]);
+int reproducir_traza(FILE *traza, long *referencias);
+int ejecutar_reemplazo(int argc, char *argv[]);
+void mostrar_uso(const char *programa);
 
-/* ==================== FUNCIONES DE LISTA ENLAZADA ==================== */
+/* ==================== FUNCIONES AUXILIARES ==================== */
 
 /**
- * Agrega un nuevo proceso a la lista enlazada
+ * Fija la semilla del generador de numeros aleatorios
  */
-void agregar_proceso(int id, int tamano, int direccion) {
-    Proceso *nuevo;
-    Proceso *actual;
+void semilla_aleatoria(unsigned long semilla) {
+    estado_aleatorio = semilla & 0xFFFFFFFFUL;
+    if (estado_aleatorio == 0) {
+        estado_aleatorio = 1;  /* xorshift no puede partir de 0 */
+    }
+}
+
+/**
+ * Generador xorshift de 32 bits sobre un estado dado (cada hilo el suyo)
+ */
+unsigned long aleatorio_de(unsigned long *estado) {
+    unsigned long x;
     
-    nuevo = (Proceso *)malloc(sizeof(Proceso));
-    if (nuevo == NULL) {
-        printf("Error: No se pudo asignar memoria para el proceso.\n");
-        return;
+    x = *estado;
+    x ^= (x << 13) & 0xFFFFFFFFUL;
+    x ^= x >> 17;
+    x ^= (x << 5) & 0xFFFFFFFFUL;
+    *estado = x;
+    return x;
+}
+
+/**
+ * Generador xorshift de 32 bits: reproducible y con estado propio
+ */
+unsigned long siguiente_aleatorio(void) {
+    return aleatorio_de(&estado_aleatorio);
+}
+
+/**
+ * Devuelve un entero aleatorio en [minimo, maximo]
+ */
+int aleatorio_entre(int minimo, int maximo) {
+    return minimo + (int)(siguiente_aleatorio() % (unsigned long)(maximo - minimo + 1));
+}
+
+/**
+ * Devuelve un instante en nanosegundos para medir intervalos
+ */
+double tiempo_ns(void) {
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0
+    struct timespec ahora;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return ahora.tv_sec * 1e9 + ahora.tv_nsec;
+#else
+    return clock() * (1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+/**
+ * Escribe 'valor' en 'cantidad' celdas consecutivas del vector de memoria.
+ * Usa AVX2 (8 celdas por instruccion) o SSE2 (4 celdas) si el compilador
+ * los habilita, y completa el resto celda por celda
+ */
+void llenar_celdas(int *destino, int cantidad, int valor) {
+    int i;
+#if defined(__AVX2__)
+    __m256i bloque;
+#elif defined(__SSE2__)
+    __m128i bloque;
+#endif
+    
+    i = 0;
+#if defined(__AVX2__)
+    bloque = _mm256_set1_epi32(valor);
+    for (; i + 8 <= cantidad; i += 8) {
+        _mm256_storeu_si256((__m256i *)(destino + i), bloque);
+    }
+#elif defined(__SSE2__)
+    bloque = _mm_set1_epi32(valor);
+    for (; i + 4 <= cantidad; i += 4) {
+        _mm_storeu_si128((__m128i *)(destino + i), bloque);
+    }
+#endif
+    for (; i < cantidad; i++) {
+        destino[i] = valor;
+    }
+}
+
+/* ==================== PERFILADO ==================== */
+
+#if defined(PERFILADO)
+/**
+ * Lee el contador de ciclos del procesador (0 si no hay)
+ */
+unsigned long leer_ciclos(void) {
+#if defined(CICLOS_DISPONIBLES)
+    return (unsigned long)__builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Marca el inicio de una llamada a la operacion
+ */
+void perfil_entrar(int operacion) {
+    MedicionPerfil *medicion;
+    
+    medicion = &perfil[operacion];
+    medicion->inicio_revisados = perfil_revisados;
+    medicion->inicio_nodos = perfil_nodos;
+    medicion->inicio_ciclos = leer_ciclos();
+    medicion->inicio_ns = tiempo_ns();
+}
+
+/**
+ * Acumula el tiempo y los contadores de la llamada en curso
+ */
+void perfil_salir(int operacion) {
+    MedicionPerfil *medicion;
+    double ns;
+    long cantidad;
+    
+    medicion = &perfil[operacion];
+    ns = tiempo_ns() - medicion->inicio_ns;
+    medicion->ciclos_total += (double)(leer_ciclos() - medicion->inicio_ciclos);
+    medicion->llamadas++;
+    medicion->ns_total += ns;
+    if (ns > medicion->ns_maximo) {
+        medicion->ns_maximo = ns;
+    }
+    cantidad = perfil_revisados - medicion->inicio_revisados;
+    medicion->revisados += cantidad;
+    if (cantidad > medicion->revisados_maximo) {
+        medicion->revisados_maximo = cantidad;
     }
+    cantidad = perfil_nodos - medicion->inicio_nodos;
+    medicion->nodos += cantidad;
+    if (cantidad > medicion->nodos_maximo) {
+        medicion->nodos_maximo = cantidad;
+    }
+}
+
+/**
+ * Muestra las mediciones de las operaciones llamadas al menos una vez
+ */
+void mostrar_perfil(void) {
+    int i;
+    MedicionPerfil *medicion;
     
-    nuevo->id = id;
-    nuevo->tamano_requerido = tamano;
-    nuevo->direccion_asignada = direccion;
-    nuevo->siguiente = NULL;
+    printf("\n================================================= PERFIL ==================================================\n");
+    printf("%-20s %10s %11s %11s %11s %9s %14s %14s\n", "Operacion", "Llamadas",
+           "Total (ms)", "Media (ns)", "Max. (ns)", "Ciclos", "Revisados", "Nodos");
+    printf("%-20s %10s %11s %11s %11s %9s %14s %14s\n", "", "", "", "", "", "(media)",
+           "(media/max)", "(media/max)");
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+    for (i = 0; i < NUM_PERFILES; i++) {
+        medicion = &perfil[i];
+        if (medicion->llamadas == 0) {
+            continue;
+        }
+        printf("%-20s %10ld %11.3f %11.0f %11.0f %9.0f %8.1f/%-5ld %8.1f/%-5ld\n",
+               nombres_perfil[i], medicion->llamadas, medicion->ns_total / 1e6,
+               medicion->ns_total / medicion->llamadas, medicion->ns_maximo,
+               medicion->ciclos_total / medicion->llamadas,
+               (double)medicion->revisados / medicion->llamadas, medicion->revisados_maximo,
+               (double)medicion->nodos / medicion->llamadas, medicion->nodos_maximo);
+    }
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+    printf("Revisados: palabras de mapas de bits, nodos del arbol y huecos examinados.\n");
+    printf("Nodos: ranuras del indice por ID y procesos de la cola recorridos.\n");
+    printf("===========================================================================================================\n");
+}
+#endif
+
+/* ==================== FUNCIONES DE MAPA DE BITS ==================== */
+
+/**
+ * Devuelve la posicion del bit activo menos significativo (palabra != 0)
+ */
+int primer_bit(unsigned long palabra) {
+#if defined(__GNUC__)
+    return __builtin_ctzl(palabra);
+#else
+    int posicion;
     
-    /* Si la lista esta vacia, el nuevo proceso es el primero */
-    if (lista_procesos == NULL) {
-        lista_procesos = nuevo;
-    } else {
-        /* Agregar al final de la lista */
-        actual = lista_procesos;
-        while (actual->siguiente != NULL) {
-            actual = actual->siguiente;
+    posicion = 0;
+    while ((palabra & 1UL) == 0) {
+        palabra >>= 1;
+        posicion++;
+    }
+    return posicion;
+#endif
+}
+
+/**
+ * Crea un mapa de bits con todos los elementos marcados como disponibles
+ */
+int mapa_crear(MapaBits *mapa, int num_bits) {
+    int i;
+    int sobrantes;
+    
+    mapa->num_bits = num_bits;
+    mapa->num_palabras = (num_bits + BITS_POR_PALABRA - 1) / BITS_POR_PALABRA;
+    mapa->num_resumen = (mapa->num_palabras + BITS_POR_PALABRA - 1) / BITS_POR_PALABRA;
+    mapa->palabras = (unsigned long *)malloc(mapa->num_palabras * sizeof(unsigned long));
+    mapa->resumen = (unsigned long *)malloc(mapa->num_resumen * sizeof(unsigned long));
+    if (mapa->palabras == NULL || mapa->resumen == NULL) {
+        mapa_destruir(mapa);
+        return 0;
+    }
+    
+    /* Todas las palabras llenas salvo los bits sobrantes de la ultima */
+    for (i = 0; i < mapa->num_palabras; i++) {
+        mapa->palabras[i] = ~0UL;
+    }
+    sobrantes = mapa->num_palabras * BITS_POR_PALABRA - num_bits;
+    if (sobrantes > 0 && mapa->num_palabras > 0) {
+        mapa->palabras[mapa->num_palabras - 1] >>= sobrantes;
+    }
+    
+    for (i = 0; i < mapa->num_resumen; i++) {
+        mapa->resumen[i] = ~0UL;
+    }
+    sobrantes = mapa->num_resumen * BITS_POR_PALABRA - mapa->num_palabras;
+    if (sobrantes > 0 && mapa->num_resumen > 0) {
+        mapa->resumen[mapa->num_resumen - 1] >>= sobrantes;
+    }
+    return 1;
+}
+
+/**
+ * Libera los arreglos del mapa de bits
+ */
+void mapa_destruir(MapaBits *mapa) {
+    if (mapa->palabras != NULL) {
+        free(mapa->palabras);
+    }
+    if (mapa->resumen != NULL) {
+        free(mapa->resumen);
+    }
+    mapa->palabras = NULL;
+    mapa->resumen = NULL;
+    mapa->num_bits = 0;
+    mapa->num_palabras = 0;
+    mapa->num_resumen = 0;
+}
+
+/**
+ * Marca todos los elementos como no disponibles
+ */
+void mapa_limpiar(MapaBits *mapa) {
+    int i;
+    
+    for (i = 0; i < mapa->num_palabras; i++) {
+        mapa->palabras[i] = 0;
+    }
+    for (i = 0; i < mapa->num_resumen; i++) {
+        mapa->resumen[i] = 0;
+    }
+}
+
+/**
+ * Devuelve 1 si el elemento esta disponible
+ */
+int mapa_consultar(const MapaBits *mapa, int indice) {
+    if (indice < 0 || indice >= mapa->num_bits) {
+        return 0;
+    }
+    return (int)((mapa->palabras[indice / BITS_POR_PALABRA] >> (indice % BITS_POR_PALABRA)) & 1UL);
+}
+
+/**
+ * Marca un elemento como disponible
+ */
+void mapa_activar(MapaBits *mapa, int indice) {
+    int palabra;
+    
+    palabra = indice / BITS_POR_PALABRA;
+    mapa->palabras[palabra] |= 1UL << (indice % BITS_POR_PALABRA);
+    mapa->resumen[palabra / BITS_POR_PALABRA] |= 1UL << (palabra % BITS_POR_PALABRA);
+}
+
+/**
+ * Marca un elemento como no disponible
+ */
+void mapa_desactivar(MapaBits *mapa, int indice) {
+    int palabra;
+    
+    palabra = indice / BITS_POR_PALABRA;
+    mapa->palabras[palabra] &= ~(1UL << (indice % BITS_POR_PALABRA));
+    if (mapa->palabras[palabra] == 0) {
+        mapa->resumen[palabra / BITS_POR_PALABRA] &= ~(1UL << (palabra % BITS_POR_PALABRA));
+    }
+}
+
+/**
+ * Devuelve el primer elemento disponible con indice >= desde, o -1 si no hay
+ */
+int mapa_buscar_desde(const MapaBits *mapa, int desde) {
+    int palabra;
+    int r;
+    unsigned long bits;
+    
+    if (desde < 0) {
+        desde = 0;
+    }
+    if (desde >= mapa->num_bits) {
+        return -1;
+    }
+    
+    /* Primero la palabra que contiene 'desde', ignorando los bits anteriores */
+    palabra = desde / BITS_POR_PALABRA;
+    PERFIL_CONTAR(perfil_revisados);
+    bits = mapa->palabras[palabra] & (~0UL << (desde % BITS_POR_PALABRA));
+    if (bits != 0) {
+        return palabra * BITS_POR_PALABRA + primer_bit(bits);
+    }
+    
+    /* Luego el resumen para saltar directamente a la siguiente palabra no vacia */
+    palabra++;
+    if (palabra >= mapa->num_palabras) {
+        return -1;
+    }
+    r = palabra / BITS_POR_PALABRA;
+    bits = mapa->resumen[r] & (~0UL << (palabra % BITS_POR_PALABRA));
+    while (bits == 0) {
+        PERFIL_CONTAR(perfil_revisados);
+        r++;
+        if (r >= mapa->num_resumen) {
+            return -1;
         }
-        actual->siguiente = nuevo;
+        bits = mapa->resumen[r];
     }
+    palabra = r * BITS_POR_PALABRA + primer_bit(bits);
+    return palabra * BITS_POR_PALABRA + primer_bit(mapa->palabras[palabra]);
 }
 
 /**
- * Elimina un proceso de la lista enlazada por su ID
+ * Devuelve la posicion del bit activo mas significativo (palabra != 0)
  */
-int eliminar_proceso(int id) {
-    Proceso *actual;
-    Proceso *anterior;
-    Proceso *temp;
+int ultimo_bit(unsigned long palabra) {
+#if defined(__GNUC__)
+    return BITS_POR_PALABRA - 1 - __builtin_clzl(palabra);
+#else
+    int posicion;
     
-    if (lista_procesos == NULL) {
-        return 0;  /* Lista vacia */
+    posicion = -1;
+    while (palabra != 0) {
+        palabra >>= 1;
+        posicion++;
     }
+    return posicion;
+#endif
+}
+
+/**
+ * Devuelve el ultimo elemento disponible del mapa, o -1 si no hay
+ */
+int mapa_buscar_ultimo(const MapaBits *mapa) {
+    int r;
+    int palabra;
     
-    actual = lista_procesos;
-    anterior = NULL;
+    for (r = mapa->num_resumen - 1; r >= 0; r--) {
+        PERFIL_CONTAR(perfil_revisados);
+        if (mapa->resumen[r] != 0) {
+            palabra = r * BITS_POR_PALABRA + ultimo_bit(mapa->resumen[r]);
+            return palabra * BITS_POR_PALABRA + ultimo_bit(mapa->palabras[palabra]);
+        }
+    }
+    return -1;
+}
+
+/* ==================== FUNCIONES DEL POOL DE PROCESOS ==================== */
+
+/**
+ * Reserva un bloque de 'cantidad' nodos y los encadena a la lista de libres
+ */
+int pool_crecer(int cantidad) {
+    BloqueProcesos *bloque;
+    int i;
     
-    /* Buscar el proceso en la lista */
-    while (actual != NULL && actual->id != id) {
-        anterior = actual;
-        actual = actual->siguiente;
+    if (cantidad < 16) {
+        cantidad = 16;
     }
     
-    /* Si no se encontro el proceso */
-    if (actual == NULL) {
+    /* Cabecera y nodos en una sola reserva */
+    bloque = (BloqueProcesos *)malloc(sizeof(BloqueProcesos) + cantidad * sizeof(Proceso));
+    if (bloque == NULL) {
         return 0;
     }
+    bloque->nodos = (Proceso *)(bloque + 1);
+    bloque->capacidad = cantidad;
+    bloque->siguiente = bloques_procesos;
+    bloques_procesos = bloque;
     
-    /* Si es el primer nodo */
-    if (anterior == NULL) {
-        lista_procesos = actual->siguiente;
-    } else {
-        anterior->siguiente = actual->siguiente;
+    for (i = cantidad - 1; i >= 0; i--) {
+        bloque->nodos[i].siguiente = nodos_libres;
+        nodos_libres = &bloque->nodos[i];
+    }
+    capacidad_pool += cantidad;
+    return 1;
+}
+
+/**
+ * Obtiene un nodo del pool; solo reserva memoria si el pool esta agotado
+ */
+Proceso* pool_obtener(void) {
+    Proceso *nodo;
+    
+    if (nodos_libres == NULL && !pool_crecer(capacidad_pool)) {
+        return NULL;
+    }
+    nodo = nodos_libres;
+    nodos_libres = nodo->siguiente;
+    return nodo;
+}
+
+/**
+ * Devuelve un nodo al pool para reutilizarlo
+ */
+void pool_devolver(Proceso *nodo) {
+    nodo->siguiente = nodos_libres;
+    nodos_libres = nodo;
+}
+
+/**
+ * Libera todos los bloques del pool de una vez
+ */
+void pool_destruir(void) {
+    BloqueProcesos *bloque;
+    
+    while (bloques_procesos != NULL) {
+        bloque = bloques_procesos;
+        bloques_procesos = bloque->siguiente;
+        free(bloque);
+    }
+    nodos_libres = NULL;
+    capacidad_pool = 0;
+}
+
+/* ==================== FUNCIONES DEL INDICE HASH ==================== */
+
+/**
+ * Funcion hash multiplicativa para IDs de proceso
+ */
+unsigned long hash_proceso(int id) {
+    return ((unsigned long)id * 2654435761UL) & (unsigned long)(capacidad_indice - 1);
+}
+
+/**
+ * Inserta un proceso en la tabla hash, duplicandola si supera la mitad de carga
+ */
+int indice_insertar(Proceso *proceso) {
+    Proceso **anterior_indice;
+    int capacidad_anterior;
+    int nueva_capacidad;
+    int i;
+    unsigned long ranura;
+    
+    if ((procesos_en_indice + 1) * 2 > capacidad_indice) {
+        nueva_capacidad = capacidad_indice == 0 ? 16 : capacidad_indice * 2;
+        while (nueva_capacidad < num_particiones * 2) {
+            nueva_capacidad *= 2;
+        }
+        
+        anterior_indice = indice_procesos;
+        capacidad_anterior = capacidad_indice;
+        indice_procesos = (Proceso **)calloc(nueva_capacidad, sizeof(Proceso *));
+        if (indice_procesos == NULL) {
+            indice_procesos = anterior_indice;
+            return 0;
+        }
+        capacidad_indice = nueva_capacidad;
+        
+        /* Reubicar las entradas existentes en la nueva tabla */
+        for (i = 0; i < capacidad_anterior; i++) {
+            if (anterior_indice[i] != NULL) {
+                ranura = hash_proceso(anterior_indice[i]->id);
+                while (indice_procesos[ranura] != NULL) {
+                    ranura = (ranura + 1) & (unsigned long)(capacidad_indice - 1);
+                }
+                indice_procesos[ranura] = anterior_indice[i];
+            }
+        }
+        if (anterior_indice != NULL) {
+            free(anterior_indice);
+        }
+    }
+    
+    ranura = hash_proceso(proceso->id);
+    while (indice_procesos[ranura] != NULL) {
+        ranura = (ranura + 1) & (unsigned long)(capacidad_indice - 1);
+    }
+    indice_procesos[ranura] = proceso;
+    procesos_en_indice++;
+    return 1;
+}
+
+/**
+ * Quita un proceso de la tabla hash y lo devuelve (NULL si no existe).
+ * Usa borrado por desplazamiento hacia atras para no dejar marcas de borrado
+ */
+Proceso* indice_extraer(int id) {
+    Proceso *encontrado;
+    unsigned long mascara;
+    unsigned long hueco;
+    unsigned long ranura;
+    unsigned long ideal;
+    
+    if (capacidad_indice == 0) {
+        return NULL;
+    }
+    
+    mascara = (unsigned long)(capacidad_indice - 1);
+    hueco = hash_proceso(id);
+    while (indice_procesos[hueco] != NULL && indice_procesos[hueco]->id != id) {
+        PERFIL_CONTAR(perfil_nodos);
+        hueco = (hueco + 1) & mascara;
+    }
+    encontrado = indice_procesos[hueco];
+    if (encontrado == NULL) {
+        return NULL;
+    }
+    
+    /* Mover hacia el hueco las entradas cuya posicion ideal no queda entre ambos */
+    indice_procesos[hueco] = NULL;
+    ranura = (hueco + 1) & mascara;
+    while (indice_procesos[ranura] != NULL) {
+        ideal = hash_proceso(indice_procesos[ranura]->id);
+        if (((ranura - ideal) & mascara) >= ((ranura - hueco) & mascara)) {
+            indice_procesos[hueco] = indice_procesos[ranura];
+            indice_procesos[ranura] = NULL;
+            hueco = ranura;
+        }
+        ranura = (ranura + 1) & mascara;
+    }
+    
+    procesos_en_indice--;
+    return encontrado;
+}
+
+/* ==================== FUNCIONES DE LISTA ENLAZADA ==================== */
+
+/**
+ * Agrega un nuevo proceso al final de la lista enlazada y al indice hash.
+ * Devuelve el nodo creado o NULL si no hubo memoria
+ */
+Proceso* agregar_proceso(int id, int tamano, int direccion, int particion) {
+    Proceso *nuevo;
+    
+    nuevo = pool_obtener();
+    if (nuevo == NULL) {
+        printf("Error: No se pudo asignar memoria para el proceso.\n");
+        return NULL;
+    }
+    
+    nuevo->id = id;
+    nuevo->tamano_requerido = tamano;
+    nuevo->direccion_asignada = direccion;
+    nuevo->particion = particion;
+    nuevo->tabla_paginas = NULL;
+    nuevo->siguiente = NULL;
+    nuevo->anterior = ultimo_proceso;
+    
+    if (!indice_insertar(nuevo)) {
+        printf("Error: No se pudo asignar memoria para el indice de procesos.\n");
+        pool_devolver(nuevo);
+        return NULL;
+    }
+    
+    /* Enlazar al final usando el puntero al ultimo nodo */
+    if (ultimo_proceso == NULL) {
+        lista_procesos = nuevo;
+    } else {
+        ultimo_proceso->siguiente = nuevo;
+    }
+    ultimo_proceso = nuevo;
+    return nuevo;
+}
+
+/**
+ * Elimina un proceso de la lista enlazada por su ID
+ */
+int eliminar_proceso(int id) {
+    Proceso *actual;
+    
+    actual = indice_extraer(id);
+    
+    /* Si no se encontro el proceso */
+    if (actual == NULL) {
+        return 0;
+    }
+    
+    /* Desenlazar el nodo sin recorrer la lista */
+    if (actual->anterior == NULL) {
+        lista_procesos = actual->siguiente;
+    } else {
+        actual->anterior->siguiente = actual->siguiente;
+    }
+    if (actual->siguiente == NULL) {
+        ultimo_proceso = actual->anterior;
+    } else {
+        actual->siguiente->anterior = actual->anterior;
+    }
+    
+    pool_devolver(actual);
+    return 1;  /* Eliminacion exitosa */
+}
+
+/**
+ * Busca un proceso por su ID en el indice hash
+ */
+Proceso* buscar_proceso(int id) {
+    unsigned long ranura;
+    
+    PERFIL_ENTRAR(PERFIL_BUSCAR);
+    if (capacidad_indice == 0) {
+        return PERFIL_SALIR(PERFIL_BUSCAR, (Proceso *)NULL);
+    }
+    
+    ranura = hash_proceso(id);
+    while (indice_procesos[ranura] != NULL) {
+        PERFIL_CONTAR(perfil_nodos);
+        if (indice_procesos[ranura]->id == id) {
+            return PERFIL_SALIR(PERFIL_BUSCAR, indice_procesos[ranura]);
+        }
+        ranura = (ranura + 1) & (unsigned long)(capacidad_indice - 1);
+    }
+    return PERFIL_SALIR(PERFIL_BUSCAR, (Proceso *)NULL);
+}
+
+/* ==================== POLITICAS DE UBICACION ==================== */
+
+PoliticaUbicacion politicas[] = {
+    { "primer", "Primer Ajuste (First Fit)", buscar_primer_ajuste },
+    { "mejor", "Mejor Ajuste (Best Fit)", buscar_mejor_ajuste },
+    { "peor", "Peor Ajuste (Worst Fit)", buscar_peor_ajuste },
+    { "siguiente", "Siguiente Ajuste (Next Fit)", buscar_siguiente_ajuste }
+};
+
+#define NUM_POLITICAS ((int)(sizeof(politicas) / sizeof(politicas[0])))
+
+/**
+ * Ordena indices de particion por tamano y, a igual tamano, por indice
+ */
+int comparar_por_tamano(const void *a, const void *b) {
+    int x;
+    int y;
+    
+    x = *(const int *)a;
+    y = *(const int *)b;
+    if (tabla_particiones.tamano[x] != tabla_particiones.tamano[y]) {
+        return tabla_particiones.tamano[x] < tabla_particiones.tamano[y] ? -1 : 1;
+    }
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * Construye los indices de particiones de tamano variable: el orden por
+ * tamano con su mapa de libres (Mejor y Peor Ajuste) y el arbol de maximos
+ * por direccion (Primer y Siguiente Ajuste). Todas las particiones libres
+ */
+int construir_indices_variables(void) {
+    int i;
+    
+    orden_por_tamano = (int *)malloc(num_particiones * sizeof(int));
+    rango_por_tamano = (int *)malloc(num_particiones * sizeof(int));
+    tamanos_ordenados = (int *)malloc(num_particiones * sizeof(int));
+    hojas_arbol = 1;
+    while (hojas_arbol < num_particiones) {
+        hojas_arbol *= 2;
+    }
+    arbol_libres = (int *)calloc(2 * hojas_arbol, sizeof(int));
+    if (orden_por_tamano == NULL || rango_por_tamano == NULL ||
+        tamanos_ordenados == NULL || arbol_libres == NULL ||
+        !mapa_crear(&mapa_por_tamano, num_particiones)) {
+        return 0;
+    }
+    
+    for (i = 0; i < num_particiones; i++) {
+        orden_por_tamano[i] = i;
+    }
+    qsort(orden_por_tamano, num_particiones, sizeof(int), comparar_por_tamano);
+    for (i = 0; i < num_particiones; i++) {
+        rango_por_tamano[orden_por_tamano[i]] = i;
+        tamanos_ordenados[i] = tabla_particiones.tamano[orden_por_tamano[i]];
+    }
+    
+    /* Hojas con el tamano de cada particion libre y nodos con el maximo */
+    for (i = 0; i < num_particiones; i++) {
+        arbol_libres[hojas_arbol + i] = tabla_particiones.tamano[i];
+    }
+    for (i = hojas_arbol - 1; i >= 1; i--) {
+        arbol_libres[i] = arbol_libres[2 * i] > arbol_libres[2 * i + 1] ?
+                          arbol_libres[2 * i] : arbol_libres[2 * i + 1];
+    }
+    return 1;
+}
+
+/**
+ * Cambia el valor de una hoja del arbol de maximos y actualiza sus ancestros
+ */
+void arbol_actualizar(int indice, int valor) {
+    int nodo;
+    int maximo;
+    
+    nodo = hojas_arbol + indice;
+    arbol_libres[nodo] = valor;
+    for (nodo /= 2; nodo >= 1; nodo /= 2) {
+        maximo = arbol_libres[2 * nodo] > arbol_libres[2 * nodo + 1] ?
+                 arbol_libres[2 * nodo] : arbol_libres[2 * nodo + 1];
+        if (arbol_libres[nodo] == maximo) {
+            break;  /* Los ancestros ya no cambian */
+        }
+        arbol_libres[nodo] = maximo;
+    }
+}
+
+/**
+ * Primera hoja con indice >= desde y valor >= tamano en el subarbol 'nodo'
+ * que cubre [izq, der], o -1. Solo desciende por ramas que pueden servir
+ */
+int arbol_buscar(int nodo, int izq, int der, int desde, int tamano) {
+    int medio;
+    int resultado;
+    
+    PERFIL_CONTAR(perfil_revisados);
+    if (der < desde || arbol_libres[nodo] < tamano) {
+        return -1;
+    }
+    if (izq == der) {
+        return izq;
+    }
+    medio = (izq + der) / 2;
+    resultado = arbol_buscar(2 * nodo, izq, medio, desde, tamano);
+    if (resultado == -1) {
+        resultado = arbol_buscar(2 * nodo + 1, medio + 1, der, desde, tamano);
+    }
+    return resultado;
+}
+
+/**
+ * Primera posicion del orden por tamano cuyo tamano es >= tamano
+ */
+int primera_por_tamano(int tamano) {
+    int izq;
+    int der;
+    int medio;
+    
+    izq = 0;
+    der = num_particiones;
+    while (izq < der) {
+        PERFIL_CONTAR(perfil_revisados);
+        medio = izq + (der - izq) / 2;
+        if (tamanos_ordenados[medio] < tamano) {
+            izq = medio + 1;
+        } else {
+            der = medio;
+        }
+    }
+    return izq;
+}
+
+/**
+ * Primer Ajuste: la particion libre de menor direccion donde quepa
+ */
+int buscar_primer_ajuste(int tamano) {
+    int indice;
+    
+    if (!particiones_variables) {
+        /* Todas miden tamano_particion: la primera libre es la primera que sirve */
+        indice = mapa_buscar_desde(&mapa_libres, 0);
+        if (indice == -1 || tabla_particiones.tamano[indice] < tamano) {
+            return -1;
+        }
+        return indice;
+    }
+    return arbol_buscar(1, 0, hojas_arbol - 1, 0, tamano);
+}
+
+/**
+ * Mejor Ajuste: la particion libre mas pequena donde quepa (a igual tamano,
+ * la de menor direccion), buscada en el orden por tamano
+ */
+int buscar_mejor_ajuste(int tamano) {
+    int posicion;
+    
+    if (!particiones_variables) {
+        return buscar_primer_ajuste(tamano);
+    }
+    posicion = mapa_buscar_desde(&mapa_por_tamano, primera_por_tamano(tamano));
+    return posicion == -1 ? -1 : orden_por_tamano[posicion];
+}
+
+/**
+ * Peor Ajuste: la particion libre mas grande (a igual tamano, la de menor
+ * direccion) si el proceso cabe en ella
+ */
+int buscar_peor_ajuste(int tamano) {
+    int posicion;
+    
+    if (!particiones_variables) {
+        return buscar_primer_ajuste(tamano);
+    }
+    posicion = mapa_buscar_ultimo(&mapa_por_tamano);
+    if (posicion == -1 || tamanos_ordenados[posicion] < tamano) {
+        return -1;
+    }
+    /* Primera libre de ese mismo tamano en el orden (menor indice) */
+    posicion = mapa_buscar_desde(&mapa_por_tamano,
+                                 primera_por_tamano(tamanos_ordenados[posicion]));
+    return orden_por_tamano[posicion];
+}
+
+/**
+ * Siguiente Ajuste: como Primer Ajuste pero continuando despues de la
+ * ultima particion asignada y dando la vuelta al final de la tabla
+ */
+int buscar_siguiente_ajuste(int tamano) {
+    int indice;
+    
+    if (!particiones_variables) {
+        indice = mapa_buscar_desde(&mapa_libres, ultima_asignada + 1);
+        if (indice == -1) {
+            indice = mapa_buscar_desde(&mapa_libres, 0);
+        }
+        if (indice == -1 || tabla_particiones.tamano[indice] < tamano) {
+            return -1;
+        }
+        return indice;
+    }
+    indice = arbol_buscar(1, 0, hojas_arbol - 1, ultima_asignada + 1, tamano);
+    if (indice == -1) {
+        indice = arbol_buscar(1, 0, hojas_arbol - 1, 0, tamano);
+    }
+    return indice;
+}
+
+/**
+ * Devuelve la politica con ese nombre o NULL si no existe
+ */
+const PoliticaUbicacion* buscar_politica(const char *nombre) {
+    int i;
+    
+    for (i = 0; i < NUM_POLITICAS; i++) {
+        if (strcmp(politicas[i].nombre, nombre) == 0) {
+            return &politicas[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Devuelve 1 si la particion esta ocupada y 0 si esta libre
+ */
+int estado_particion(int indice) {
+    return (int)((tabla_particiones.ocupadas[indice / BITS_POR_PALABRA] >>
+                  (indice % BITS_POR_PALABRA)) & 1UL);
+}
+
+/**
+ * Marca una particion como ocupada en todos los indices de libres
+ */
+void ocupar_particion(int indice) {
+    tabla_particiones.ocupadas[indice / BITS_POR_PALABRA] |= 1UL << (indice % BITS_POR_PALABRA);
+    mapa_desactivar(&mapa_libres, indice);
+    if (particiones_variables) {
+        mapa_desactivar(&mapa_por_tamano, rango_por_tamano[indice]);
+        arbol_actualizar(indice, 0);
+    }
+}
+
+/**
+ * Marca una particion como libre en todos los indices de libres
+ */
+void desocupar_particion(int indice) {
+    tabla_particiones.ocupadas[indice / BITS_POR_PALABRA] &=
+        ~(1UL << (indice % BITS_POR_PALABRA));
+    mapa_activar(&mapa_libres, indice);
+    if (particiones_variables) {
+        mapa_activar(&mapa_por_tamano, rango_por_tamano[indice]);
+        arbol_actualizar(indice, tabla_particiones.tamano[indice]);
+    }
+}
+
+/* ==================== PARTICIONAMIENTO DINAMICO ==================== */
+
+/**
+ * Calcula la clase y subclase de un tamano en el indice de huecos
+ */
+void clase_de_tamano(int tamano, int *clase, int *subclase) {
+    int bit;
+    
+    if (tamano < NUM_SUBCLASES) {
+        *clase = 0;
+        *subclase = tamano;
+    } else {
+        bit = ultimo_bit((unsigned long)tamano);
+        *clase = bit - SUBCLASES_LOG2 + 1;
+        *subclase = (tamano >> (bit - SUBCLASES_LOG2)) - NUM_SUBCLASES;
+    }
+}
+
+/**
+ * Agrega un hueco al principio de la lista de su subclase
+ */
+void hueco_insertar(int bloque) {
+    int clase;
+    int subclase;
+    int cabeza;
+    
+    clase_de_tamano(bloques[bloque].tamano, &clase, &subclase);
+    cabeza = cabeza_clase[clase][subclase];
+    bloques[bloque].libre = 1;
+    bloques[bloque].proceso = NULL;
+    bloques[bloque].anterior_clase = -1;
+    bloques[bloque].siguiente_clase = cabeza;
+    if (cabeza != -1) {
+        bloques[cabeza].anterior_clase = bloque;
+    }
+    cabeza_clase[clase][subclase] = bloque;
+    mapa_subclases[clase] |= 1UL << subclase;
+    mapa_clases |= 1UL << clase;
+    num_huecos++;
+    memoria_libre += bloques[bloque].tamano;
+}
+
+/**
+ * Quita un hueco de la lista de su subclase
+ */
+void hueco_quitar(int bloque) {
+    int clase;
+    int subclase;
+    
+    clase_de_tamano(bloques[bloque].tamano, &clase, &subclase);
+    if (bloques[bloque].anterior_clase != -1) {
+        bloques[bloques[bloque].anterior_clase].siguiente_clase = bloques[bloque].siguiente_clase;
+    } else {
+        cabeza_clase[clase][subclase] = bloques[bloque].siguiente_clase;
+    }
+    if (bloques[bloque].siguiente_clase != -1) {
+        bloques[bloques[bloque].siguiente_clase].anterior_clase = bloques[bloque].anterior_clase;
+    }
+    if (cabeza_clase[clase][subclase] == -1) {
+        mapa_subclases[clase] &= ~(1UL << subclase);
+        if (mapa_subclases[clase] == 0) {
+            mapa_clases &= ~(1UL << clase);
+        }
+    }
+    bloques[bloque].libre = 0;
+    num_huecos--;
+    memoria_libre -= bloques[bloque].tamano;
+}
+
+/**
+ * Obtiene un registro de bloque sin uso, duplicando el arreglo si hace falta.
+ * Devuelve su indice o -1 si no hubo memoria
+ */
+int bloque_nuevo(void) {
+    Bloque *ampliado;
+    int nueva_capacidad;
+    int i;
+    int bloque;
+    
+    if (bloques_sin_uso == -1) {
+        nueva_capacidad = capacidad_bloques == 0 ? 64 : capacidad_bloques * 2;
+        ampliado = (Bloque *)realloc(bloques, nueva_capacidad * sizeof(Bloque));
+        if (ampliado == NULL) {
+            return -1;
+        }
+        bloques = ampliado;
+        for (i = nueva_capacidad - 1; i >= capacidad_bloques; i--) {
+            bloques[i].siguiente_clase = bloques_sin_uso;
+            bloques_sin_uso = i;
+        }
+        capacidad_bloques = nueva_capacidad;
+    }
+    bloque = bloques_sin_uso;
+    bloques_sin_uso = bloques[bloque].siguiente_clase;
+    num_bloques++;
+    return bloque;
+}
+
+/**
+ * Devuelve un registro de bloque a la pila de reciclados
+ */
+void bloque_reciclar(int bloque) {
+    bloques[bloque].siguiente_clase = bloques_sin_uso;
+    bloques_sin_uso = bloque;
+    num_bloques--;
+}
+
+/**
+ * Busca un hueco donde quepa 'tamano' KB. Se redondea el pedido a la
+ * siguiente subclase, de modo que cualquier hueco de esa subclase o de una
+ * mayor sirve y se toma en O(1) con los mapas de bits. Solo si no hay
+ * ninguno se recorre la subclase exacta del pedido. Devuelve -1 si no cabe
+ */
+int buscar_hueco(int tamano) {
+    int redondeado;
+    int clase;
+    int subclase;
+    int bloque;
+    unsigned long bits;
+    
+    redondeado = tamano;
+    if (tamano >= NUM_SUBCLASES) {
+        bits = 1UL << (ultimo_bit((unsigned long)tamano) - SUBCLASES_LOG2);
+        if ((unsigned long)tamano <= (unsigned long)INT_MAX - (bits - 1)) {
+            redondeado = tamano + (int)(bits - 1);
+        }
+    }
+    clase_de_tamano(redondeado, &clase, &subclase);
+    PERFIL_CONTAR(perfil_revisados);
+    
+    bits = mapa_subclases[clase] & (~0UL << subclase);
+    if (bits == 0) {
+        bits = mapa_clases & (~0UL << (clase + 1));
+        if (bits != 0) {
+            clase = primer_bit(bits);
+            bits = mapa_subclases[clase];
+        }
+    }
+    if (bits != 0) {
+        return cabeza_clase[clase][primer_bit(bits)];
+    }
+    
+    /* Ultimo recurso: huecos de la misma subclase que el pedido */
+    clase_de_tamano(tamano, &clase, &subclase);
+    for (bloque = cabeza_clase[clase][subclase]; bloque != -1;
+         bloque = bloques[bloque].siguiente_clase) {
+        PERFIL_CONTAR(perfil_revisados);
+        if (bloques[bloque].tamano >= tamano) {
+            return bloque;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Convierte el principio de un hueco en un bloque ocupado de 'tamano' KB;
+ * el resto queda como un hueco nuevo a continuacion. Devuelve 0 si no hubo
+ * memoria para el registro del resto
+ */
+int tallar_bloque(int hueco, int tamano) {
+    int resto;
+    
+    resto = -1;
+    if (bloques[hueco].tamano > tamano) {
+        resto = bloque_nuevo();
+        if (resto == -1) {
+            return 0;
+        }
+    }
+    
+    hueco_quitar(hueco);
+    if (resto != -1) {
+        bloques[resto].inicio = bloques[hueco].inicio + tamano;
+        bloques[resto].tamano = bloques[hueco].tamano - tamano;
+        bloques[resto].anterior = hueco;
+        bloques[resto].siguiente = bloques[hueco].siguiente;
+        if (bloques[hueco].siguiente != -1) {
+            bloques[bloques[hueco].siguiente].anterior = resto;
+        }
+        bloques[hueco].siguiente = resto;
+        bloques[hueco].tamano = tamano;
+        hueco_insertar(resto);
+    }
+    return 1;
+}
+
+/**
+ * Libera un bloque ocupado fusionandolo con los huecos vecinos.
+ * Devuelve el indice del hueco resultante
+ */
+int liberar_bloque(int bloque) {
+    int vecino;
+    
+    /* Absorber el hueco siguiente */
+    vecino = bloques[bloque].siguiente;
+    if (vecino != -1 && bloques[vecino].libre) {
+        hueco_quitar(vecino);
+        bloques[bloque].tamano += bloques[vecino].tamano;
+        bloques[bloque].siguiente = bloques[vecino].siguiente;
+        if (bloques[vecino].siguiente != -1) {
+            bloques[bloques[vecino].siguiente].anterior = bloque;
+        }
+        bloque_reciclar(vecino);
+    }
+    
+    /* Dejarse absorber por el hueco anterior */
+    vecino = bloques[bloque].anterior;
+    if (vecino != -1 && bloques[vecino].libre) {
+        hueco_quitar(vecino);
+        bloques[vecino].tamano += bloques[bloque].tamano;
+        bloques[vecino].siguiente = bloques[bloque].siguiente;
+        if (bloques[bloque].siguiente != -1) {
+            bloques[bloques[bloque].siguiente].anterior = vecino;
+        }
+        bloque_reciclar(bloque);
+        bloque = vecino;
+    }
+    
+    hueco_insertar(bloque);
+    return bloque;
+}
+
+/**
+ * Tamano del mayor hueco: se recorre solo la subclase no vacia mas alta
+ */
+int mayor_hueco(void) {
+    int clase;
+    int bloque;
+    int mayor;
+    
+    if (mapa_clases == 0) {
+        return 0;
+    }
+    clase = ultimo_bit(mapa_clases);
+    mayor = 0;
+    for (bloque = cabeza_clase[clase][ultimo_bit(mapa_subclases[clase])]; bloque != -1;
+         bloque = bloques[bloque].siguiente_clase) {
+        if (bloques[bloque].tamano > mayor) {
+            mayor = bloques[bloque].tamano;
+        }
+    }
+    return mayor;
+}
+
+/**
+ * Porcentaje de memoria libre que no esta en el mayor hueco o bloque libre
+ * (0 si toda la memoria libre es contigua o si las particiones son fijas)
+ */
+float fragmentacion_externa(void) {
+    long libre;
+    
+    if (esquema_memoria == ESQUEMA_BUDDY) {
+        libre = tamano_total_memoria - buddy_asignado;
+        if (libre == 0) {
+            return 0.0;
+        }
+        return (float)(100.0 * (libre - mayor_bloque_buddy()) / libre);
+    }
+    if (esquema_memoria != ESQUEMA_DINAMICO || memoria_libre == 0) {
+        return 0.0;
+    }
+    return (float)(100.0 * (memoria_libre - mayor_hueco()) / memoria_libre);
+}
+
+/**
+ * Configura el particionamiento dinamico: toda la memoria es un hueco y
+ * cada proceso recibe un bloque de su tamano exacto. 'maximo_proceso' es el
+ * tope del tamano aleatorio de los procesos
+ */
+void configurar_dinamica(int total, int maximo_proceso) {
+    int i;
+    int j;
+    int bloque;
+    
+    esquema_memoria = ESQUEMA_DINAMICO;
+    tamano_total_memoria = total;
+    tamano_particion = maximo_proceso;
+    num_particiones = 0;
+    particiones_variables = 0;
+    
+    reservar_vector_memoria();
+    if (!pool_crecer(64)) {
+        printf("Error: No se pudo asignar memoria para el pool de procesos.\n");
+        exit(1);
+    }
+    
+    for (i = 0; i < NUM_CLASES; i++) {
+        for (j = 0; j < NUM_SUBCLASES; j++) {
+            cabeza_clase[i][j] = -1;
+        }
+        mapa_subclases[i] = 0;
+    }
+    mapa_clases = 0;
+    num_huecos = 0;
+    memoria_libre = 0;
+    
+    bloque = bloque_nuevo();
+    if (bloque == -1) {
+        printf("Error: No se pudo asignar memoria para la tabla de bloques.\n");
+        exit(1);
+    }
+    bloques[bloque].inicio = 0;
+    bloques[bloque].tamano = total;
+    bloques[bloque].anterior = -1;
+    bloques[bloque].siguiente = -1;
+    hueco_insertar(bloque);
+}
+
+/**
+ * Asigna al proceso 'id_proceso' un bloque de su tamano exacto. Mismos
+ * valores de retorno que asignar_proceso(), con el indice de bloque en
+ * lugar del de particion
+ */
+int asignar_dinamico(int id_proceso, int tamano_proceso) {
+    int hueco;
+    Proceso *nuevo;
+    
+    if (tamano_proceso <= 0) {
+        return -1;
+    }
+    hueco = buscar_hueco(tamano_proceso);
+    if (hueco == -1) {
+        return -1;
+    }
+    
+    nuevo = agregar_proceso(id_proceso, tamano_proceso, bloques[hueco].inicio, hueco);
+    if (nuevo == NULL) {
+        return -2;
+    }
+    if (!tallar_bloque(hueco, tamano_proceso)) {
+        eliminar_proceso(id_proceso);
+        return -2;
+    }
+    bloques[hueco].proceso = nuevo;
+    
+    if (memoria != NULL) {
+        llenar_celdas(memoria + bloques[hueco].inicio, tamano_proceso, id_proceso);
+    }
+    return hueco;
+}
+
+/* ==================== COMPACTACION ==================== */
+
+/**
+ * Copia 'largo' KB del vector de memoria de 'origen' a 'destino' (pueden
+ * solaparse). Devuelve los KB reubicados (0 si el tramo no se mueve)
+ */
+long mover_tramo(long origen, long destino, long largo) {
+    if (largo == 0 || origen == destino) {
+        return 0;
+    }
+    if (memoria != NULL) {
+        memmove(memoria + destino, memoria + origen, (size_t)largo * sizeof(int));
+    }
+    return largo;
+}
+
+/**
+ * Desliza los bloques ocupados hacia la direccion 0 en orden de direccion
+ * y deja toda la memoria libre en un unico hueco al final. Los bloques
+ * ocupados seguidos forman un tramo que se mueve con un solo memmove().
+ * Devuelve los KB reubicados
+ */
+long compactar_dinamico(void) {
+    int bloque;
+    int siguiente;
+    int ultimo;
+    int hueco;
+    int cero_libre;
+    long destino;
+    long origen_tramo;
+    long destino_tramo;
+    long largo_tramo;
+    long movidos;
+    
+    destino = 0;
+    origen_tramo = 0;
+    destino_tramo = 0;
+    largo_tramo = 0;
+    movidos = 0;
+    ultimo = -1;
+    cero_libre = 0;
+    for (bloque = 0; bloque != -1; bloque = siguiente) {
+        siguiente = bloques[bloque].siguiente;
+        if (bloques[bloque].libre) {
+            hueco_quitar(bloque);
+            if (bloque == 0) {
+                cero_libre = 1;
+            } else {
+                bloque_reciclar(bloque);
+            }
+            continue;
+        }
+        
+        if (bloques[bloque].inicio != origen_tramo + largo_tramo) {
+            movidos += mover_tramo(origen_tramo, destino_tramo, largo_tramo);
+            origen_tramo = bloques[bloque].inicio;
+            destino_tramo = destino;
+            largo_tramo = 0;
+        }
+        largo_tramo += bloques[bloque].tamano;
+        
+        /* El bloque de la direccion 0 debe seguir siendo el registro 0 */
+        if (cero_libre) {
+            bloques[0] = bloques[bloque];
+            bloques[0].proceso->particion = 0;
+            bloque_reciclar(bloque);
+            bloque = 0;
+            cero_libre = 0;
+        }
+        bloques[bloque].inicio = (int)destino;
+        bloques[bloque].proceso->direccion_asignada = (int)destino;
+        bloques[bloque].anterior = ultimo;
+        if (ultimo != -1) {
+            bloques[ultimo].siguiente = bloque;
+        }
+        ultimo = bloque;
+        destino += bloques[bloque].tamano;
+    }
+    movidos += mover_tramo(origen_tramo, destino_tramo, largo_tramo);
+    if (ultimo != -1) {
+        bloques[ultimo].siguiente = -1;
+    }
+    
+    if (destino < tamano_total_memoria) {
+        /* Habia al menos un hueco, asi que hay un registro reciclado */
+        hueco = cero_libre ? 0 : bloque_nuevo();
+        bloques[hueco].inicio = (int)destino;
+        bloques[hueco].tamano = tamano_total_memoria - (int)destino;
+        bloques[hueco].anterior = ultimo;
+        bloques[hueco].siguiente = -1;
+        if (ultimo != -1) {
+            bloques[ultimo].siguiente = hueco;
+        }
+        hueco_insertar(hueco);
+        
+        /* Solo quedan celdas viejas hasta el final del ultimo tramo */
+        if (memoria != NULL && origen_tramo + largo_tramo > destino) {
+            llenar_celdas(memoria + destino, (int)(origen_tramo + largo_tramo - destino), -1);
+        }
+    }
+    return movidos;
+}
+
+/**
+ * Con particiones fijas solo se puede mudar cada proceso, en orden de
+ * direccion, a la primera particion libre anterior donde quepa. No se
+ * muda a una particion mayor que la suya, para no aumentar la
+ * fragmentacion interna: si la del primer ajuste lo es, se siguen
+ * revisando las libres anteriores. Devuelve los KB reubicados
+ */
+long compactar_particiones(void) {
+    int i;
+    int j;
+    int usado;
+    long movidos;
+    Proceso *proceso;
+    
+    movidos = 0;
+    for (i = 0; i < num_particiones; i++) {
+        if (!estado_particion(i)) {
+            continue;
+        }
+        usado = tabla_particiones.tamano_usado[i];
+        j = buscar_primer_ajuste(usado);
+        while (j != -1 && j < i && (tabla_particiones.tamano[j] < usado ||
+                                    tabla_particiones.tamano[j] > tabla_particiones.tamano[i])) {
+            j = mapa_buscar_desde(&mapa_libres, j + 1);
+        }
+        if (j == -1 || j > i) {
+            continue;
+        }
+        
+        proceso = tabla_particiones.proceso[i];
+        if (memoria != NULL) {
+            memmove(memoria + tabla_particiones.direccion_inicio[j],
+                    memoria + tabla_particiones.direccion_inicio[i], (size_t)usado * sizeof(int));
+            llenar_celdas(memoria + tabla_particiones.direccion_inicio[i], usado, -1);
+        }
+        estadisticas.kb_asignados += tabla_particiones.tamano[j] - tabla_particiones.tamano[i];
+        estadisticas.suma_fragmentacion +=
+            calcular_fragmentacion(tabla_particiones.tamano[j], usado) -
+            calcular_fragmentacion(tabla_particiones.tamano[i], usado);
+        
+        ocupar_particion(j);
+        tabla_particiones.id_proceso[j] = proceso->id;
+        tabla_particiones.tamano_usado[j] = usado;
+        tabla_particiones.proceso[j] = proceso;
+        desocupar_particion(i);
+        tabla_particiones.id_proceso[i] = -1;
+        tabla_particiones.tamano_usado[i] = 0;
+        tabla_particiones.proceso[i] = NULL;
+        proceso->particion = j;
+        proceso->direccion_asignada = tabla_particiones.direccion_inicio[j];
+        movidos += usado;
+    }
+    return movidos;
+}
+
+/**
+ * Compacta la memoria con el motor activo y acumula el costo. Devuelve los
+ * KB reubicados o -1 si el motor no admite compactacion (buddy y
+ * paginacion)
+ */
+long compactar_memoria(void) {
+    long movidos;
+    double inicio;
+    
+    if (esquema_memoria == ESQUEMA_BUDDY || esquema_memoria == ESQUEMA_PAGINACION) {
+        return -1;
+    }
+    PERFIL_ENTRAR(PERFIL_COMPACTAR);
+    inicio = tiempo_ns();
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        movidos = compactar_dinamico();
+    } else {
+        movidos = compactar_particiones();
+    }
+    ns_ultima_compactacion = tiempo_ns() - inicio;
+    ns_compactacion += ns_ultima_compactacion;
+    compactaciones++;
+    kb_compactados += movidos;
+    return PERFIL_SALIR(PERFIL_COMPACTAR, movidos);
+}
+
+/**
+ * Muestra el costo acumulado de las compactaciones (nada si no hubo)
+ */
+void mostrar_metricas_compactacion(void) {
+    if (compactaciones == 0) {
+        return;
+    }
+    printf("Compactaciones: %ld (%ld automaticas)  KB movidos: %ld  Tiempo: %.3f ms\n",
+           compactaciones, compactaciones_automaticas, kb_compactados, ns_compactacion / 1e6);
+}
+
+/**
+ * Compacta la memoria a pedido del usuario e informa el costo
+ */
+void compactar_interactivo(void) {
+    long movidos;
+    
+    printf("\n--- COMPACTAR MEMORIA ---\n");
+    movidos = compactar_memoria();
+    if (movidos < 0) {
+        printf("Error: El sistema de companeros y la paginacion no se compactan.\n");
+        return;
+    }
+    printf(">>> %ld KB movidos en %.3f ms.\n", movidos, ns_ultima_compactacion / 1e6);
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        printf(">>> Memoria libre: %d KB en %d hueco(s).\n", memoria_libre, num_huecos);
+    } else {
+        printf(">>> Particiones libres: %d de %d.\n",
+               num_particiones - estadisticas.procesos, num_particiones);
+    }
+    drenar_cola(1);
+}
+
+/* ==================== SISTEMA DE COMPANEROS (BUDDY) ==================== */
+
+/**
+ * Menor orden k tal que 2^k >= tamano
+ */
+int orden_buddy(int tamano) {
+    if (tamano <= 1) {
+        return 0;
+    }
+    return ultimo_bit((unsigned long)(tamano - 1)) + 1;
+}
+
+/**
+ * Agrega el bloque de orden 'orden' en 'direccion' a los libres
+ */
+void buddy_marcar_libre(int direccion, int orden) {
+    mapa_activar(&buddy_libres[orden], direccion >> orden);
+    buddy_num_libres[orden]++;
+    ordenes_libres |= 1UL << orden;
+}
+
+/**
+ * Quita el bloque de orden 'orden' en 'direccion' de los libres
+ */
+void buddy_quitar_libre(int direccion, int orden) {
+    mapa_desactivar(&buddy_libres[orden], direccion >> orden);
+    buddy_num_libres[orden]--;
+    if (buddy_num_libres[orden] == 0) {
+        ordenes_libres &= ~(1UL << orden);
+    }
+}
+
+/**
+ * Devuelve al sistema el bloque de orden 'orden' en 'direccion',
+ * fusionandolo con su companero mientras este tambien este libre.
+ * Devuelve la direccion del bloque libre resultante
+ */
+int buddy_liberar_bloque(int direccion, int orden) {
+    int companero;
+    
+    while (orden + 1 < ORDENES_BUDDY) {
+        companero = direccion ^ (1 << orden);
+        if (!mapa_consultar(&buddy_libres[orden], companero >> orden)) {
+            break;
+        }
+        buddy_quitar_libre(companero, orden);
+        direccion &= ~(1 << orden);
+        orden++;
+    }
+    buddy_marcar_libre(direccion, orden);
+    return direccion;
+}
+
+/**
+ * Configura el sistema de companeros: la memoria se divide en los mayores
+ * bloques alineados de potencia de 2 que caben en ella (toda la memoria si
+ * el total es potencia de 2). 'maximo_proceso' es el tope del tamano
+ * aleatorio de los procesos
+ */
+void configurar_buddy(int total, int maximo_proceso) {
+    int k;
+    int direccion;
+    
+    esquema_memoria = ESQUEMA_BUDDY;
+    tamano_total_memoria = total;
+    tamano_particion = maximo_proceso;
+    num_particiones = 0;
+    particiones_variables = 0;
+    
+    reservar_vector_memoria();
+    if (!pool_crecer(64)) {
+        printf("Error: No se pudo asignar memoria para el pool de procesos.\n");
+        exit(1);
+    }
+    
+    /* Un mapa de libres y uno de ocupados por orden, uno por bloque posible */
+    for (k = 0; k < ORDENES_BUDDY; k++) {
+        if ((total >> k) > 0) {
+            if (!mapa_crear(&buddy_libres[k], total >> k) ||
+                !mapa_crear(&buddy_ocupados[k], total >> k)) {
+                printf("Error: No se pudo asignar memoria para los mapas del buddy.\n");
+                exit(1);
+            }
+            mapa_limpiar(&buddy_libres[k]);
+            mapa_limpiar(&buddy_ocupados[k]);
+        }
+        buddy_num_libres[k] = 0;
+    }
+    ordenes_libres = 0;
+    buddy_asignado = 0;
+    buddy_usado = 0;
+    
+    /* Bloques iniciales de mayor a menor: cada uno queda alineado a su tamano */
+    direccion = 0;
+    for (k = ORDENES_BUDDY - 1; k >= 0; k--) {
+        if ((total - direccion) >> k > 0) {
+            buddy_marcar_libre(direccion, k);
+            direccion += 1 << k;
+        }
+    }
+}
+
+/**
+ * Asigna al proceso 'id_proceso' un bloque de 2^k KB, dividiendo el menor
+ * bloque libre suficiente. Mismos valores de retorno que asignar_proceso(),
+ * con el orden del bloque en lugar del indice de particion
+ */
+int asignar_buddy(int id_proceso, int tamano_proceso) {
+    int orden;
+    int k;
+    int indice;
+    int direccion;
+    Proceso *nuevo;
+    
+    if (tamano_proceso <= 0 || tamano_proceso > tamano_total_memoria) {
+        return -1;
+    }
+    orden = orden_buddy(tamano_proceso);
+    if (orden >= ORDENES_BUDDY) {
+        return -1;
+    }
+    
+    /* Menor orden con bloques libres que sea suficiente */
+    if ((ordenes_libres >> orden) == 0) {
+        return -1;
+    }
+    k = orden + primer_bit(ordenes_libres >> orden);
+    indice = mapa_buscar_desde(&buddy_libres[k], 0);
+    direccion = indice << k;
+    
+    nuevo = agregar_proceso(id_proceso, tamano_proceso, direccion, orden);
+    if (nuevo == NULL) {
+        return -2;
+    }
+    
+    buddy_quitar_libre(direccion, k);
+    
+    /* Dividir: la mitad superior de cada division queda libre */
+    while (k > orden) {
+        k--;
+        buddy_marcar_libre(direccion + (1 << k), k);
+    }
+    mapa_activar(&buddy_ocupados[orden], direccion >> orden);
+    buddy_asignado += 1L << orden;
+    buddy_usado += tamano_proceso;
+    
+    if (memoria != NULL) {
+        llenar_celdas(memoria + direccion, tamano_proceso, id_proceso);
+    }
+    return orden;
+}
+
+/**
+ * Libera el bloque de un proceso. Devuelve la direccion del bloque libre
+ * resultante tras las fusiones
+ */
+int liberar_buddy(Proceso *proceso) {
+    int orden;
+    int direccion;
+    
+    orden = proceso->particion;
+    direccion = proceso->direccion_asignada;
+    if (memoria != NULL) {
+        llenar_celdas(memoria + direccion, proceso->tamano_requerido, -1);
+    }
+    mapa_desactivar(&buddy_ocupados[orden], direccion >> orden);
+    buddy_asignado -= 1L << orden;
+    buddy_usado -= proceso->tamano_requerido;
+    
+    return buddy_liberar_bloque(direccion, orden);
+}
+
+/**
+ * Tamano del mayor bloque libre
+ */
+int mayor_bloque_buddy(void) {
+    if (ordenes_libres == 0) {
+        return 0;
+    }
+    return 1 << ultimo_bit(ordenes_libres);
+}
+
+/**
+ * Identifica el bloque que empieza en 'direccion' (libre u ocupado) y
+ * devuelve 1 si esta libre y 0 si esta asignado; su orden queda en 'orden'
+ */
+int bloque_buddy_en(int direccion, int *orden) {
+    int k;
+    
+    for (k = ORDENES_BUDDY - 1; k >= 0; k--) {
+        if ((direccion & ((1 << k) - 1)) != 0) {
+            continue;
+        }
+        *orden = k;
+        if (mapa_consultar(&buddy_libres[k], direccion >> k)) {
+            return 1;
+        }
+        if (mapa_consultar(&buddy_ocupados[k], direccion >> k)) {
+            return 0;
+        }
+    }
+    *orden = 0;
+    return 1;
+}
+
+/**
+ * Comparador de procesos por direccion para qsort
+ */
+int comparar_por_direccion(const void *a, const void *b) {
+    int x;
+    int y;
+    
+    x = (*(Proceso * const *)a)->direccion_asignada;
+    y = (*(Proceso * const *)b)->direccion_asignada;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * Arreglo con los procesos activos ordenados por direccion (lo libera el
+ * llamador), o NULL si no hay procesos o no hubo memoria
+ */
+Proceso **procesos_por_direccion(void) {
+    Proceso **orden;
+    Proceso *actual;
+    int i;
+    
+    if (procesos_en_indice == 0) {
+        return NULL;
+    }
+    orden = (Proceso **)malloc(procesos_en_indice * sizeof(Proceso *));
+    if (orden == NULL) {
+        return NULL;
+    }
+    i = 0;
+    for (actual = lista_procesos; actual != NULL; actual = actual->siguiente) {
+        orden[i++] = actual;
+    }
+    qsort(orden, procesos_en_indice, sizeof(Proceso *), comparar_por_direccion);
+    return orden;
+}
+
+/* ==================== PAGINACION ==================== */
+
+/**
+ * Configura la paginacion: la memoria se divide en marcos de 'pagina' KB
+ * (los KB que sobran al final no se usan) y todos quedan en la pila de
+ * libres. 'maximo_proceso' es el tope del tamano aleatorio de los procesos
+ */
+void configurar_paginacion(int total, int pagina, int maximo_proceso) {
+    int i;
+    
+    esquema_memoria = ESQUEMA_PAGINACION;
+    tamano_total_memoria = total;
+    tamano_pagina = pagina;
+    tamano_particion = maximo_proceso;
+    num_particiones = 0;
+    particiones_variables = 0;
+    num_marcos = total / pagina;
+    
+    reservar_vector_memoria();
+    if (!pool_crecer(64)) {
+        printf("Error: No se pudo asignar memoria para el pool de procesos.\n");
+        exit(1);
+    }
+    
+    marcos_libres = (int *)malloc(num_marcos * sizeof(int));
+    marco_proceso = (int *)malloc(num_marcos * sizeof(int));
+    marco_usado = (int *)malloc(num_marcos * sizeof(int));
+    if (marcos_libres == NULL || marco_proceso == NULL || marco_usado == NULL) {
+        printf("Error: No se pudo asignar memoria para los marcos.\n");
+        exit(1);
+    }
+    
+    /* La pila se llena al reves para entregar primero los marcos bajos */
+    for (i = 0; i < num_marcos; i++) {
+        marcos_libres[i] = num_marcos - 1 - i;
+        marco_proceso[i] = -1;
+        marco_usado[i] = 0;
+    }
+    num_marcos_libres = num_marcos;
+    entradas_tablas = 0;
+    
+    if (!configurar_tlb(tlb_entradas, tlb_vias)) {
+        exit(1);
+    }
+    if (politica_reemplazo != REEMPLAZO_NINGUNO && !reemplazo_configurar(politica_reemplazo)) {
+        exit(1);
+    }
+}
+
+/**
+ * Reserva un TLB vacio de 'entradas' entradas agrupadas en conjuntos de
+ * 'vias' (vias == entradas: totalmente asociativo) y reinicia sus
+ * contadores. Devuelve 0 si la geometria no es valida
+ */
+int configurar_tlb(int entradas, int vias) {
+    EntradaTLB *nuevo;
+    int i;
+    
+    if (entradas <= 0 || vias <= 0 || entradas % vias != 0) {
+        printf("Error: el TLB necesita un numero de entradas multiplo de las vias.\n");
+        return 0;
+    }
+    nuevo = (EntradaTLB *)malloc(entradas * sizeof(EntradaTLB));
+    if (nuevo == NULL) {
+        printf("Error: No se pudo asignar memoria para el TLB.\n");
+        return 0;
+    }
+    if (tlb != NULL) {
+        free(tlb);
+    }
+    tlb = nuevo;
+    tlb_entradas = entradas;
+    tlb_vias = vias;
+    tlb_conjuntos = entradas / vias;
+    for (i = 0; i < entradas; i++) {
+        tlb[i].proceso = -1;
+        tlb[i].uso = 0;
+    }
+    tlb_reloj = 0;
+    tlb_aciertos = 0;
+    tlb_fallos = 0;
+    referencias_invalidas = 0;
+    return 1;
+}
+
+/**
+ * Carga el proceso 'id_proceso' en tantos marcos libres como paginas
+ * necesita, sin que tengan que ser contiguos. Con memoria virtual no se
+ * carga ninguna: cada pagina entra a un marco en su primera referencia.
+ * Devuelve el numero de paginas, -1 si no hay marcos suficientes o -2 si
+ * falta memoria
+ */
+int asignar_paginado(int id_proceso, int tamano_proceso) {
+    int paginas;
+    int marco;
+    int usado;
+    int i;
+    int *tabla;
+    Proceso *nuevo;
+    
+    if (tamano_proceso <= 0) {
+        return -1;
+    }
+    paginas = (tamano_proceso + tamano_pagina - 1) / tamano_pagina;
+    if (paginas > num_marcos_libres && politica_reemplazo == REEMPLAZO_NINGUNO) {
+        return -1;
+    }
+    tabla = (int *)malloc(paginas * sizeof(int));
+    if (tabla == NULL) {
+        printf("Error: No se pudo asignar memoria para la tabla de paginas.\n");
+        return -2;
+    }
+    if (politica_reemplazo != REEMPLAZO_NINGUNO) {
+        for (i = 0; i < paginas; i++) {
+            tabla[i] = -1;
+        }
+        nuevo = agregar_proceso(id_proceso, tamano_proceso, -1, paginas);
+        if (nuevo == NULL) {
+            free(tabla);
+            return -2;
+        }
+        nuevo->tabla_paginas = tabla;
+        entradas_tablas += paginas;
+        return paginas;
+    }
+    
+    /* Los marcos salen de la cima de la pila en O(1) cada uno */
+    for (i = 0; i < paginas; i++) {
+        tabla[i] = marcos_libres[num_marcos_libres - 1 - i];
+    }
+    nuevo = agregar_proceso(id_proceso, tamano_proceso,
+                            marcos_libres[num_marcos_libres - 1] * tamano_pagina, paginas);
+    if (nuevo == NULL) {
+        free(tabla);
+        return -2;
+    }
+    nuevo->tabla_paginas = tabla;
+    num_marcos_libres -= paginas;
+    entradas_tablas += paginas;
+    
+    for (i = 0; i < paginas; i++) {
+        marco = tabla[i];
+        usado = i < paginas - 1 ? tamano_pagina : tamano_proceso - i * tamano_pagina;
+        marco_proceso[marco] = id_proceso;
+        marco_usado[marco] = usado;
+        if (memoria != NULL) {
+            llenar_celdas(memoria + marco * tamano_pagina, usado, id_proceso);
+        }
+    }
+    return paginas;
+}
+
+/**
+ * Devuelve a la pila los marcos de un proceso, invalida sus traducciones
+ * en el TLB y libera su tabla de paginas. Devuelve los marcos liberados
+ */
+int liberar_paginado(Proceso *proceso) {
+    int paginas;
+    int marco;
+    int i;
+    
+    paginas = proceso->particion;
+    for (i = paginas - 1; i >= 0; i--) {
+        marco = proceso->tabla_paginas[i];
+        if (marco == -1) {
+            continue;
+        }
+        if (politica_reemplazo != REEMPLAZO_NINGUNO) {
+            reemplazo_soltar(marco);
+            estadisticas_marco(marco_usado[marco], -1);
+        }
+        if (memoria != NULL) {
+            llenar_celdas(memoria + marco * tamano_pagina, marco_usado[marco], -1);
+        }
+        marco_proceso[marco] = -1;
+        marco_usado[marco] = 0;
+        marcos_libres[num_marcos_libres++] = marco;
+    }
+    tlb_invalidar_proceso(proceso->id);
+    free(proceso->tabla_paginas);
+    proceso->tabla_paginas = NULL;
+    entradas_tablas -= paginas;
+    return paginas;
+}
+
+/**
+ * Invalida las entradas del TLB de un proceso. Los IDs no se reutilizan,
+ * asi que no darian aciertos falsos; se quitan para no ocupar vias
+ */
+void tlb_invalidar_proceso(int id_proceso) {
+    int i;
+    
+    for (i = 0; i < tlb_entradas; i++) {
+        if (tlb[i].proceso == id_proceso) {
+            tlb[i].proceso = -1;
+            tlb[i].uso = 0;
+        }
+    }
+}
+
+/**
+ * Invalida la traduccion de una pagina desalojada (solo puede estar en el
+ * conjunto de su pagina)
+ */
+void tlb_invalidar_pagina(int id_proceso, int pagina) {
+    EntradaTLB *conjunto;
+    int i;
+    
+    conjunto = tlb + (pagina % tlb_conjuntos) * tlb_vias;
+    for (i = 0; i < tlb_vias; i++) {
+        if (conjunto[i].proceso == id_proceso && conjunto[i].pagina == pagina) {
+            conjunto[i].proceso = -1;
+            conjunto[i].uso = 0;
+        }
+    }
+}
+
+/**
+ * Con memoria virtual, devuelve el marco de una pagina de 'proceso' y
+ * registra la referencia; si no esta residente la carga (fallo de pagina)
+ */
+int marco_de_pagina(Proceso *proceso, int pagina) {
+    int marco;
+    int usado;
+    
+    marco = proceso->tabla_paginas[pagina];
+    if (marco != -1) {
+        reemplazo_acceso(marco);
+        return marco;
+    }
+    marco = reemplazo_fallo(proceso->id, pagina);
+    usado = pagina < proceso->particion - 1 ? tamano_pagina :
+            proceso->tamano_requerido - pagina * tamano_pagina;
+    proceso->tabla_paginas[pagina] = marco;
+    marco_proceso[marco] = proceso->id;
+    marco_usado[marco] = usado;
+    estadisticas_marco(usado, 1);
+    if (memoria != NULL) {
+        llenar_celdas(memoria + marco * tamano_pagina, usado, proceso->id);
+    }
+    return marco;
+}
+
+/**
+ * Traduce la direccion virtual 'direccion' (KB desde el inicio del
+ * proceso) a una direccion fisica. Se busca la pagina en su conjunto del
+ * TLB; si no esta, se recorre la tabla de paginas y la traduccion
+ * reemplaza a la entrada menos usada del conjunto. Con memoria virtual
+ * cada referencia llega tambien a la politica de reemplazo, y una pagina
+ * no residente se carga. Devuelve 1 si acerto en el TLB, 0 si recorrio la
+ * tabla y -1 si la direccion no es valida
+ */
+int traducir_direccion(int id_proceso, long direccion, long *fisica) {
+    Proceso *proceso;
+    EntradaTLB *conjunto;
+    EntradaTLB *victima;
+    int pagina;
+    int i;
+    
+    proceso = buscar_proceso(id_proceso);
+    if (proceso == NULL || proceso->tabla_paginas == NULL ||
+        direccion < 0 || direccion >= proceso->tamano_requerido) {
+        referencias_invalidas++;
+        return -1;
+    }
+    pagina = (int)(direccion / tamano_pagina);
+    conjunto = tlb + (pagina % tlb_conjuntos) * tlb_vias;
+    tlb_reloj++;
+    
+    victima = conjunto;
+    for (i = 0; i < tlb_vias; i++) {
+        if (conjunto[i].proceso == id_proceso && conjunto[i].pagina == pagina) {
+            conjunto[i].uso = tlb_reloj;
+            tlb_aciertos++;
+            if (politica_reemplazo != REEMPLAZO_NINGUNO) {
+                reemplazo_acceso(conjunto[i].marco);
+            }
+            *fisica = (long)conjunto[i].marco * tamano_pagina + direccion % tamano_pagina;
+            return 1;
+        }
+        if (conjunto[i].uso < victima->uso) {
+            victima = &conjunto[i];
+        }
+    }
+    
+    /* Fallo: las entradas invalidas tienen uso 0 y se ocupan primero */
+    tlb_fallos++;
+    victima->proceso = id_proceso;
+    victima->pagina = pagina;
+    if (politica_reemplazo != REEMPLAZO_NINGUNO) {
+        victima->marco = marco_de_pagina(proceso, pagina);
+    } else {
+        victima->marco = proceso->tabla_paginas[pagina];
+    }
+    victima->uso = tlb_reloj;
+    *fisica = (long)victima->marco * tamano_pagina + direccion % tamano_pagina;
+    return 0;
+}
+
+/* ==================== REEMPLAZO DE PAGINAS ==================== */
+
+/**
+ * Indice de la politica de reemplazo con ese nombre, o -1
+ */
+int buscar_reemplazo(const char *nombre) {
+    int i;
+    
+    for (i = REEMPLAZO_FIFO; i < NUM_REEMPLAZOS; i++) {
+        if (strcmp(nombre, nombres_reemplazo[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Prepara la memoria virtual sobre los marcos ya configurados: directorio
+ * de paginas (una entrada por marco, mas otras tantas fantasmas en ARC),
+ * tabla hash de paginas y bits de referencia del reloj. Devuelve 0 si
+ * falta memoria
+ */
+int reemplazo_configurar(int politica) {
+    int cantidad;
+    int i;
+    
+    reemplazo_destruir();
+    politica_reemplazo = politica;
+    entradas_directorio = politica == REEMPLAZO_ARC ? 2 * num_marcos : num_marcos;
+    cantidad = 1;
+    while (cantidad < 2 * entradas_directorio) {
+        cantidad *= 2;
+    }
+    directorio = (EntradaPagina *)malloc((entradas_directorio + NUM_LISTAS) *
+                                         sizeof(EntradaPagina));
+    cubetas = (int *)malloc(cantidad * sizeof(int));
+    bits_referencia = (unsigned long *)calloc((num_marcos + BITS_POR_PALABRA - 1) /
+                                              BITS_POR_PALABRA + 1, sizeof(unsigned long));
+    if (directorio == NULL || cubetas == NULL || bits_referencia == NULL) {
+        printf("Error: No se pudo asignar memoria para el directorio de paginas.\n");
+        reemplazo_destruir();
+        return 0;
+    }
+    mascara_cubetas = (unsigned long)(cantidad - 1);
+    for (i = 0; i < cantidad; i++) {
+        cubetas[i] = -1;
+    }
+    
+    /* Las entradas fantasma forman una pila enlazada por 'siguiente_hash' */
+    fantasmas_libres = -1;
+    for (i = entradas_directorio - 1; i >= 0; i--) {
+        directorio[i].proceso = -1;
+        directorio[i].lista = -1;
+        if (i >= num_marcos) {
+            directorio[i].siguiente_hash = fantasmas_libres;
+            fantasmas_libres = i;
+        }
+    }
+    for (i = 0; i < NUM_LISTAS; i++) {
+        directorio[entradas_directorio + i].anterior = entradas_directorio + i;
+        directorio[entradas_directorio + i].siguiente = entradas_directorio + i;
+        largo_lista[i] = 0;
+    }
+    objetivo_t1 = 0;
+    manecilla = 0;
+    fallos_pagina = 0;
+    desalojos = 0;
+    return 1;
+}
+
+/**
+ * Libera el directorio de paginas (la politica elegida se conserva)
+ */
+void reemplazo_destruir(void) {
+    if (directorio != NULL) {
+        free(directorio);
+    }
+    if (cubetas != NULL) {
+        free(cubetas);
+    }
+    if (bits_referencia != NULL) {
+        free(bits_referencia);
+    }
+    directorio = NULL;
+    cubetas = NULL;
+    bits_referencia = NULL;
+    entradas_directorio = 0;
+}
+
+/**
+ * Cubeta de la pagina 'pagina' del proceso 'proceso'. El desplazamiento
+ * final mezcla los bits altos, para que los saltos grandes entre paginas
+ * no caigan siempre en las mismas cubetas
+ */
+unsigned long hash_pagina(int proceso, long pagina) {
+    unsigned long h;
+    
+    h = (unsigned long)pagina * 2654435761UL + (unsigned long)proceso * 40503UL;
+    h ^= h >> 16;
+    return h & mascara_cubetas;
+}
+
+/**
+ * Entrada del directorio con esa pagina (residente o fantasma), o -1
+ */
+int pagina_buscar(int proceso, long pagina) {
+    int entrada;
+    
+    entrada = cubetas[hash_pagina(proceso, pagina)];
+    while (entrada != -1 &&
+           (directorio[entrada].pagina != pagina || directorio[entrada].proceso != proceso)) {
+        entrada = directorio[entrada].siguiente_hash;
+    }
+    return entrada;
+}
+
+/**
+ * Agrega una entrada a la cubeta de su pagina
+ */
+void pagina_hash_insertar(int entrada) {
+    unsigned long cubeta;
+    
+    cubeta = hash_pagina(directorio[entrada].proceso, directorio[entrada].pagina);
+    directorio[entrada].siguiente_hash = cubetas[cubeta];
+    cubetas[cubeta] = entrada;
+}
+
+/**
+ * Quita una entrada de la cubeta de su pagina
+ */
+void pagina_hash_quitar(int entrada) {
+    int *enlace;
+    
+    enlace = &cubetas[hash_pagina(directorio[entrada].proceso, directorio[entrada].pagina)];
+    while (*enlace != entrada) {
+        enlace = &directorio[*enlace].siguiente_hash;
+    }
+    *enlace = directorio[entrada].siguiente_hash;
+}
+
+/**
+ * Saca una entrada de su lista (si esta en alguna)
+ */
+void lista_quitar(int entrada) {
+    EntradaPagina *e;
+    
+    e = &directorio[entrada];
+    if (e->lista == -1) {
+        return;
+    }
+    directorio[e->anterior].siguiente = e->siguiente;
+    directorio[e->siguiente].anterior = e->anterior;
+    largo_lista[e->lista]--;
+    e->lista = -1;
+}
+
+/**
+ * Agrega una entrada en el extremo mas reciente de una lista
+ */
+void lista_agregar(int entrada, int lista) {
+    int centinela;
+    int ultima;
+    
+    centinela = entradas_directorio + lista;
+    ultima = directorio[centinela].anterior;
+    directorio[entrada].anterior = ultima;
+    directorio[entrada].siguiente = centinela;
+    directorio[entrada].lista = lista;
+    directorio[ultima].siguiente = entrada;
+    directorio[centinela].anterior = entrada;
+    largo_lista[lista]++;
+}
+
+/**
+ * Registra una referencia a la pagina residente en 'marco'
+ */
+void reemplazo_acceso(int marco) {
+    switch (politica_reemplazo) {
+        case REEMPLAZO_LRU:
+            if (directorio[entradas_directorio + LISTA_T1].anterior != marco) {
+                lista_quitar(marco);
+                lista_agregar(marco, LISTA_T1);
+            }
+            break;
+        case REEMPLAZO_RELOJ:
+            bits_referencia[marco / BITS_POR_PALABRA] |= 1UL << (marco % BITS_POR_PALABRA);
+            break;
+        case REEMPLAZO_ARC:
+            /* Vista dos veces: pasa (o vuelve) al extremo reciente de T2 */
+            lista_quitar(marco);
+            lista_agregar(marco, LISTA_T2);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Descarta la fantasma menos reciente de B1 o B2
+ */
+void reemplazo_olvidar(int lista) {
+    int entrada;
+    
+    entrada = directorio[entradas_directorio + lista].siguiente;
+    lista_quitar(entrada);
+    pagina_hash_quitar(entrada);
+    directorio[entrada].proceso = -1;
+    directorio[entrada].siguiente_hash = fantasmas_libres;
+    fantasmas_libres = entrada;
+}
+
+/**
+ * Elige un marco segun la politica, saca su pagina y lo devuelve. Si la
+ * pagina pertenece a un proceso del simulador se invalida en su tabla y en
+ * el TLB. En ARC la pagina queda como fantasma en B1 o B2; 'caso' es 1 si
+ * la pagina pedida estaba en B2 y 2 si hay que sacar de T1 sin fantasma
+ */
+int reemplazo_desalojar(int caso) {
+    unsigned long mascara;
+    unsigned long libres;
+    Proceso *proceso;
+    int palabras;
+    int marco;
+    int fantasma;
+    int w;
+    int b;
+    
+    marco = 0;
+    if (politica_reemplazo == REEMPLAZO_RELOJ) {
+        /* Segunda oportunidad de a una palabra: se busca el primer bit en
+         * 0 desde la manecilla y se apagan los bits que se saltan */
+        palabras = (num_marcos + BITS_POR_PALABRA - 1) / BITS_POR_PALABRA;
+        for (;;) {
+            w = manecilla / BITS_POR_PALABRA;
+            b = manecilla % BITS_POR_PALABRA;
+            mascara = ~0UL << b;
+            if (w == palabras - 1 && num_marcos % BITS_POR_PALABRA != 0) {
+                mascara &= (1UL << (num_marcos % BITS_POR_PALABRA)) - 1;
+            }
+            libres = ~bits_referencia[w] & mascara;
+            if (libres != 0) {
+                b = primer_bit(libres);
+                bits_referencia[w] &= ~(mascara & ((1UL << b) - 1));
+                marco = w * BITS_POR_PALABRA + b;
+                manecilla = marco + 1 < num_marcos ? marco + 1 : 0;
+                break;
+            }
+            bits_referencia[w] &= ~mascara;
+            manecilla = (w + 1) * BITS_POR_PALABRA < num_marcos ? (w + 1) * BITS_POR_PALABRA : 0;
+        }
+    } else if (politica_reemplazo == REEMPLAZO_ARC) {
+        if (largo_lista[LISTA_T1] > 0 &&
+            (caso == 2 || largo_lista[LISTA_T2] == 0 || largo_lista[LISTA_T1] > objetivo_t1 ||
+             (caso == 1 && largo_lista[LISTA_T1] == objetivo_t1))) {
+            marco = directorio[entradas_directorio + LISTA_T1].siguiente;
+        } else {
+            marco = directorio[entradas_directorio + LISTA_T2].siguiente;
+        }
+    } else {
+        marco = directorio[entradas_directorio + LISTA_T1].siguiente;
+    }
+    desalojos++;
+    
+    /* Avisar al proceso duenio, si es uno del simulador */
+    proceso = procesos_en_indice > 0 ? buscar_proceso(directorio[marco].proceso) : NULL;
+    if (proceso != NULL) {
+        proceso->tabla_paginas[directorio[marco].pagina] = -1;
+        tlb_invalidar_pagina(proceso->id, (int)directorio[marco].pagina);
+        estadisticas_marco(marco_usado[marco], -1);
+        if (memoria != NULL) {
+            llenar_celdas(memoria + marco * tamano_pagina, marco_usado[marco], -1);
+        }
+        marco_proceso[marco] = -1;
+        marco_usado[marco] = 0;
+    }
+    
+    pagina_hash_quitar(marco);
+    if (politica_reemplazo == REEMPLAZO_ARC && caso != 2) {
+        if (fantasmas_libres == -1) {
+            reemplazo_olvidar(largo_lista[LISTA_B1] >= largo_lista[LISTA_B2] ?
+                              LISTA_B1 : LISTA_B2);
+        }
+        fantasma = fantasmas_libres;
+        fantasmas_libres = directorio[fantasma].siguiente_hash;
+        directorio[fantasma].proceso = directorio[marco].proceso;
+        directorio[fantasma].pagina = directorio[marco].pagina;
+        pagina_hash_insertar(fantasma);
+        lista_agregar(fantasma, directorio[marco].lista == LISTA_T1 ? LISTA_B1 : LISTA_B2);
+    }
+    lista_quitar(marco);
+    directorio[marco].proceso = -1;
+    return marco;
+}
+
+/**
+ * Fallo de pagina: carga la pagina en un marco libre o en uno desalojado
+ * por la politica y devuelve el marco. En ARC una fantasma de B1 (o B2)
+ * agranda (o achica) el objetivo de T1 y la pagina entra a T2
+ */
+int reemplazo_fallo(int proceso, long pagina) {
+    int entrada;
+    int destino;
+    int caso;
+    int marco;
+    long delta;
+    
+    fallos_pagina++;
+    destino = LISTA_T1;
+    caso = 0;
+    if (politica_reemplazo == REEMPLAZO_ARC) {
+        entrada = pagina_buscar(proceso, pagina);
+        if (entrada != -1 && directorio[entrada].lista == LISTA_B1) {
+            delta = largo_lista[LISTA_B1] >= largo_lista[LISTA_B2] ? 1 :
+                    largo_lista[LISTA_B2] / largo_lista[LISTA_B1];
+            objetivo_t1 = objetivo_t1 + delta < num_marcos ? objetivo_t1 + delta : num_marcos;
+            destino = LISTA_T2;
+        } else if (entrada != -1) {
+            delta = largo_lista[LISTA_B2] >= largo_lista[LISTA_B1] ? 1 :
+                    largo_lista[LISTA_B1] / largo_lista[LISTA_B2];
+            objetivo_t1 = objetivo_t1 - delta > 0 ? objetivo_t1 - delta : 0;
+            destino = LISTA_T2;
+            caso = 1;
+        }
+        if (entrada != -1) {
+            lista_quitar(entrada);
+            pagina_hash_quitar(entrada);
+            directorio[entrada].proceso = -1;
+            directorio[entrada].siguiente_hash = fantasmas_libres;
+            fantasmas_libres = entrada;
+        } else if (largo_lista[LISTA_T1] + largo_lista[LISTA_B1] >= num_marcos) {
+            /* L1 = T1 + B1 no supera c */
+            if (largo_lista[LISTA_B1] > 0) {
+                reemplazo_olvidar(LISTA_B1);
+            } else {
+                caso = 2;
+            }
+        } else if (largo_lista[LISTA_T1] + largo_lista[LISTA_T2] + largo_lista[LISTA_B1] +
+                   largo_lista[LISTA_B2] >= 2 * num_marcos) {
+            /* El directorio no supera 2c */
+            reemplazo_olvidar(LISTA_B2);
+        }
+    }
+    
+    if (num_marcos_libres > 0) {
+        marco = marcos_libres[--num_marcos_libres];
+    } else {
+        marco = reemplazo_desalojar(caso);
+    }
+    directorio[marco].proceso = proceso;
+    directorio[marco].pagina = pagina;
+    pagina_hash_insertar(marco);
+    if (politica_reemplazo == REEMPLAZO_RELOJ) {
+        bits_referencia[marco / BITS_POR_PALABRA] |= 1UL << (marco % BITS_POR_PALABRA);
+    } else {
+        lista_agregar(marco, destino);
+    }
+    return marco;
+}
+
+/**
+ * Quita del directorio la pagina de un marco que se libera (al cerrar su
+ * proceso). El marco lo devuelve el llamador a la pila de libres
+ */
+void reemplazo_soltar(int marco) {
+    lista_quitar(marco);
+    pagina_hash_quitar(marco);
+    directorio[marco].proceso = -1;
+    bits_referencia[marco / BITS_POR_PALABRA] &= ~(1UL << (marco % BITS_POR_PALABRA));
+}
+
+/**
+ * Referencia una pagina fuera del simulador (trazas de referencias).
+ * Devuelve 1 si estaba residente y 0 si hubo fallo
+ */
+int referenciar_pagina(int proceso, long pagina) {
+    int entrada;
+    
+    entrada = pagina_buscar(proceso, pagina);
+    if (entrada != -1 && entrada < num_marcos) {
+        reemplazo_acceso(entrada);
+        return 1;
+    }
+    reemplazo_fallo(proceso, pagina);
+    return 0;
+}
+
+/* ==================== FUNCIONES DE GESTION DE MEMORIA ==================== */
+
+/**
+ * Reserva las columnas de la tabla de particiones, todas libres.
+ * Devuelve 0 si falta memoria (sin dejar nada reservado)
+ */
+int crear_tabla_particiones(int cantidad) {
+    tabla_particiones.direccion_inicio = (int *)malloc(cantidad * sizeof(int));
+    tabla_particiones.tamano = (int *)malloc(cantidad * sizeof(int));
+    tabla_particiones.id_proceso = (int *)malloc(cantidad * sizeof(int));
+    tabla_particiones.tamano_usado = (int *)malloc(cantidad * sizeof(int));
+    tabla_particiones.proceso = (Proceso **)malloc(cantidad * sizeof(Proceso *));
+    tabla_particiones.ocupadas = (unsigned long *)calloc(
+        (cantidad + BITS_POR_PALABRA - 1) / BITS_POR_PALABRA, sizeof(unsigned long));
+    if (tabla_particiones.direccion_inicio == NULL || tabla_particiones.tamano == NULL ||
+        tabla_particiones.id_proceso == NULL || tabla_particiones.tamano_usado == NULL ||
+        tabla_particiones.proceso == NULL || tabla_particiones.ocupadas == NULL) {
+        destruir_tabla_particiones();
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Libera las columnas de la tabla de particiones (las que apuntan dentro
+ * de una instantanea se liberan con ella)
+ */
+void destruir_tabla_particiones(void) {
+    if (!tabla_en_instantanea) {
+        free(tabla_particiones.direccion_inicio);
+        free(tabla_particiones.tamano);
+        free(tabla_particiones.id_proceso);
+        free(tabla_particiones.tamano_usado);
+        free(tabla_particiones.ocupadas);
+    }
+    free(tabla_particiones.proceso);
+    tabla_en_instantanea = 0;
+    tabla_particiones.direccion_inicio = NULL;
+    tabla_particiones.tamano = NULL;
+    tabla_particiones.id_proceso = NULL;
+    tabla_particiones.tamano_usado = NULL;
+    tabla_particiones.proceso = NULL;
+    tabla_particiones.ocupadas = NULL;
+}
+
+/**
+ * Reserva el vector de memoria de tamano_total_memoria KB. En modo
+ * compacto cada particion o bloque guarda su extension ocupada
+ * [inicio, tamano usado, id_proceso] y el vector se reconstruye al mostrarlo
+ */
+void reservar_vector_memoria(void) {
+    if (!memoria_compacta) {
+        memoria = (int *)malloc(tamano_total_memoria * sizeof(int));
+        if (memoria == NULL) {
+            printf("Error: No se pudo asignar memoria.\n");
+            exit(1);
+        }
+        
+        /* Inicializar vector de memoria con -1 (indica espacio libre) */
+        llenar_celdas(memoria, tamano_total_memoria, -1);
+    }
+}
+
+/**
+ * Reserva el vector de memoria, la tabla, el pool y el indice de libres
+ * para num_particiones particiones de tamano_total_memoria KB en total
+ */
+void reservar_tabla(void) {
+    esquema_memoria = ESQUEMA_PARTICIONES;
+    reservar_vector_memoria();
+    
+    /* Crear tabla de particiones */
+    if (!crear_tabla_particiones(num_particiones)) {
+        printf("Error: No se pudo asignar memoria para la tabla de particiones.\n");
+        free(memoria);
+        exit(1);
+    }
+    
+    /* Reservar un nodo de proceso por particion (maximo de procesos activos) */
+    if (!pool_crecer(num_particiones)) {
+        printf("Error: No se pudo asignar memoria para el pool de procesos.\n");
+        free(memoria);
+        destruir_tabla_particiones();
+        exit(1);
+    }
+    
+    /* Crear el indice de particiones libres (todas libres al inicio) */
+    if (!mapa_crear(&mapa_libres, num_particiones)) {
+        printf("Error: No se pudo asignar memoria para el indice de particiones.\n");
+        free(memoria);
+        destruir_tabla_particiones();
+        exit(1);
+    }
+    
+    if (politica_actual == NULL) {
+        politica_actual = &politicas[0];
+    }
+    ultima_asignada = -1;
+}
+
+/**
+ * Configura la memoria con particiones fijas sin interaccion con el usuario
+ */
+void configurar_memoria(int total, int particion) {
+    int i;
+    
+    tamano_total_memoria = total;
+    tamano_particion = particion;
+    particiones_variables = 0;
+    
+    /* Calcular numero de particiones */
+    num_particiones = tamano_total_memoria / tamano_particion;
+    
+    if (num_particiones == 0) {
+        printf("Error: No se pueden crear particiones con estos valores.\n");
+        exit(1);
+    }
+    
+    reservar_tabla();
+    
+    /* Inicializar cada particion */
+    for (i = 0; i < num_particiones; i++) {
+        tabla_particiones.id_proceso[i] = -1;  /* -1 indica libre */
+        tabla_particiones.direccion_inicio[i] = i * tamano_particion;
+        tabla_particiones.tamano[i] = tamano_particion;
+        tabla_particiones.tamano_usado[i] = 0;
+        tabla_particiones.proceso[i] = NULL;
+    }
+}
+
+/**
+ * Configura particiones de tamanos distintos, contiguas en el orden dado.
+ * La memoria total es la suma de los tamanos y tamano_particion pasa a ser
+ * el de la mayor particion (tope del tamano aleatorio de los procesos)
+ */
+void configurar_particiones_variables(int cantidad, const int *tamanos) {
+    int i;
+    int direccion;
+    
+    if (cantidad <= 0) {
+        printf("Error: No se pueden crear particiones con estos valores.\n");
+        exit(1);
+    }
+    
+    num_particiones = cantidad;
+    tamano_total_memoria = 0;
+    tamano_particion = 0;
+    for (i = 0; i < cantidad; i++) {
+        if (tamanos[i] <= 0 || tamanos[i] > INT_MAX - tamano_total_memoria) {
+            printf("Error: Tamano de particion invalido.\n");
+            exit(1);
+        }
+        tamano_total_memoria += tamanos[i];
+        if (tamanos[i] > tamano_particion) {
+            tamano_particion = tamanos[i];
+        }
+    }
+    particiones_variables = 1;
+    
+    reservar_tabla();
+    
+    direccion = 0;
+    for (i = 0; i < num_particiones; i++) {
+        tabla_particiones.id_proceso[i] = -1;  /* -1 indica libre */
+        tabla_particiones.direccion_inicio[i] = direccion;
+        tabla_particiones.tamano[i] = tamanos[i];
+        tabla_particiones.tamano_usado[i] = 0;
+        tabla_particiones.proceso[i] = NULL;
+        direccion += tamanos[i];
+    }
+    
+    if (!construir_indices_variables()) {
+        printf("Error: No se pudo asignar memoria para los indices de particiones.\n");
+        exit(1);
+    }
+}
+
+/**
+ * Solicita al usuario la politica de ubicacion
+ */
+void seleccionar_politica(void) {
+    int opcion;
+    int i;
+    
+    do {
+        printf("Politicas de ubicacion:\n");
+        for (i = 0; i < NUM_POLITICAS; i++) {
+            printf("  %d. %s\n", i + 1, politicas[i].descripcion);
+        }
+        printf("Seleccione la politica: ");
+        scanf("%d", &opcion);
+        if (opcion < 1 || opcion > NUM_POLITICAS) {
+            printf("Error: Opcion invalida.\n");
+        }
+    } while (opcion < 1 || opcion > NUM_POLITICAS);
+    politica_actual = &politicas[opcion - 1];
+}
+
+/**
+ * Inicializa el sistema de memoria particionada
+ */
+void inicializar_memoria(void) {
+    int total;
+    int particion;
+    int tipo;
+    int cantidad;
+    int pagina;
+    int vias;
+    int i;
+    int *tamanos;
+    
+    printf("\n=== INICIALIZACION DEL SISTEMA DE MEMORIA ===\n");
+    
+    /* Solicitar el tipo de particionamiento */
+    do {
+        printf("Tipo de particiones (1 = iguales, 2 = de distinto tamano, 3 = dinamicas,\n");
+        printf("                     4 = buddy, 5 = paginacion): ");
+        scanf("%d", &tipo);
+        if (tipo < 1 || tipo > 5) {
+            printf("Error: Opcion invalida.\n");
+        }
+    } while (tipo < 1 || tipo > 5);
+    
+    if (tipo == 2) {
+        do {
+            printf("Ingrese la cantidad de particiones: ");
+            scanf("%d", &cantidad);
+            if (cantidad <= 0) {
+                printf("Error: La cantidad debe ser mayor a 0.\n");
+            }
+        } while (cantidad <= 0);
+        
+        tamanos = (int *)malloc(cantidad * sizeof(int));
+        if (tamanos == NULL) {
+            printf("Error: No se pudo asignar memoria.\n");
+            exit(1);
+        }
+        for (i = 0; i < cantidad; i++) {
+            do {
+                printf("Tamano de la particion %d (KB): ", i);
+                scanf("%d", &tamanos[i]);
+                if (tamanos[i] <= 0) {
+                    printf("Error: El tamano debe ser mayor a 0.\n");
+                }
+            } while (tamanos[i] <= 0);
+        }
+        
+        seleccionar_politica();
+        configurar_particiones_variables(cantidad, tamanos);
+        free(tamanos);
+        
+        printf("\n>>> Se crearon %d particiones (%d KB en total).\n",
+               num_particiones, tamano_total_memoria);
+        printf(">>> Memoria inicializada exitosamente.\n");
+        return;
+    }
+    
+    /* Solicitar tamano total de memoria */
+    do {
+        printf("Ingrese el tamano total de memoria (KB): ");
+        scanf("%d", &total);
+        if (total <= 0) {
+            printf("Error: El tamano debe ser mayor a 0.\n");
+        }
+    } while (total <= 0);
+    
+    if (tipo == 5) {
+        do {
+            printf("Ingrese el tamano de pagina (KB): ");
+            scanf("%d", &pagina);
+            if (pagina <= 0 || pagina > total) {
+                printf("Error: El tamano debe estar entre 1 y la memoria total.\n");
+            }
+        } while (pagina <= 0 || pagina > total);
+        do {
+            printf("Entradas del TLB y vias por conjunto (ej. 64 4): ");
+            scanf("%d %d", &cantidad, &vias);
+        } while (!configurar_tlb(cantidad, vias));
+        do {
+            printf("Memoria virtual (0 = no, 1 = FIFO, 2 = LRU, 3 = Reloj, 4 = ARC): ");
+            scanf("%d", &politica_reemplazo);
+            if (politica_reemplazo < REEMPLAZO_NINGUNO || politica_reemplazo >= NUM_REEMPLAZOS) {
+                printf("Error: Opcion invalida.\n");
+            }
+        } while (politica_reemplazo < REEMPLAZO_NINGUNO ||
+                 politica_reemplazo >= NUM_REEMPLAZOS);
+        
+        /* Con memoria virtual un proceso puede ser mayor que la memoria */
+        do {
+            printf("Ingrese el tamano maximo de un proceso (KB): ");
+            scanf("%d", &particion);
+            if (particion <= 0 || (particion > total && politica_reemplazo == REEMPLAZO_NINGUNO)) {
+                printf("Error: El tamano debe estar entre 1 y la memoria total.\n");
+            }
+        } while (particion <= 0 || (particion > total && politica_reemplazo == REEMPLAZO_NINGUNO));
+        
+        configurar_paginacion(total, pagina, particion);
+        printf("\n>>> Paginacion: %d marcos de %d KB, TLB de %d entradas y %d vias.\n",
+               num_marcos, tamano_pagina, tlb_entradas, tlb_vias);
+        printf(">>> Memoria inicializada exitosamente.\n");
+        return;
+    }
+    
+    if (tipo == 3 || tipo == 4) {
+        do {
+            printf("Ingrese el tamano maximo de un proceso (KB): ");
+            scanf("%d", &particion);
+            if (particion <= 0 || particion > total) {
+                printf("Error: El tamano debe estar entre 1 y la memoria total.\n");
+            }
+        } while (particion <= 0 || particion > total);
+        
+        if (tipo == 3) {
+            do {
+                printf("Umbral de compactacion automatica (%% de fragmentacion externa, 0 = nunca): ");
+                scanf("%lf", &umbral_compactacion);
+                if (umbral_compactacion < 0.0 || umbral_compactacion > 100.0) {
+                    printf("Error: El umbral debe estar entre 0 y 100.\n");
+                }
+            } while (umbral_compactacion < 0.0 || umbral_compactacion > 100.0);
+            configurar_dinamica(total, particion);
+            printf("\n>>> Particionamiento dinamico: un hueco de %d KB.\n", total);
+        } else {
+            configurar_buddy(total, particion);
+            printf("\n>>> Sistema de companeros: %d KB, mayor bloque de %d KB.\n",
+                   total, mayor_bloque_buddy());
+        }
+        printf(">>> Memoria inicializada exitosamente.\n");
+        return;
+    }
+    
+    /* Solicitar tamano de cada particion */
+    do {
+        printf("Ingrese el tamano de cada particion (KB): ");
+        scanf("%d", &particion);
+        if (particion <= 0) {
+            printf("Error: El tamano debe ser mayor a 0.\n");
+        } else if (particion > total) {
+            printf("Error: El tamano de particion no puede ser mayor que la memoria total.\n");
+            particion = 0;
+        }
+    } while (particion <= 0);
+    
+    seleccionar_politica();
+    
+    printf("\n>>> Se crearan %d particiones de %d KB cada una.\n", 
+           total / particion, particion);
+    
+    configurar_memoria(total, particion);
+    
+    printf(">>> Memoria inicializada exitosamente.\n");
+}
+
+/**
+ * Calcula el porcentaje de fragmentacion interna de una particion
+ */
+float calcular_fragmentacion(int tamano_particion, int tamano_proceso) {
+    int fragmentacion;
+    
+    if (tamano_proceso == 0) {
+        return 0.0;
+    }
+    
+    fragmentacion = tamano_particion - tamano_proceso;
+    return (fragmentacion * 100.0) / tamano_particion;
+}
+
+/**
+ * Registra un proceso admitido sin contar sus KB (con memoria virtual los
+ * cuenta estadisticas_marco() a medida que sus paginas entran a marcos)
+ */
+void estadisticas_admitir(int tamano_proceso, int tamano_asignado) {
+    estadisticas.procesos++;
+    estadisticas.suma_fragmentacion += calcular_fragmentacion(tamano_asignado, tamano_proceso);
+    estadisticas.admitidos++;
+    estadisticas.histograma[ultimo_bit((unsigned long)tamano_proceso)]++;
+}
+
+/**
+ * Registra un proceso cargado: pidio 'tamano_proceso' KB y se le reservaron
+ * 'tamano_asignado' (su particion o bloque)
+ */
+void estadisticas_cargar(int tamano_proceso, int tamano_asignado) {
+    estadisticas_admitir(tamano_proceso, tamano_asignado);
+    estadisticas.kb_usados += tamano_proceso;
+    estadisticas.kb_asignados += tamano_asignado;
+}
+
+/**
+ * Descuenta un proceso que deja la memoria, sin tocar sus KB
+ */
+void estadisticas_retirar(int tamano_proceso, int tamano_asignado) {
+    estadisticas.procesos--;
+    estadisticas.suma_fragmentacion -= calcular_fragmentacion(tamano_asignado, tamano_proceso);
+    if (estadisticas.procesos == 0) {
+        estadisticas.suma_fragmentacion = 0.0;  /* Descarta el error de redondeo */
+    }
+}
+
+/**
+ * Descuenta un proceso liberado (mismos tamanos que al cargarlo)
+ */
+void estadisticas_liberar(int tamano_proceso, int tamano_asignado) {
+    estadisticas_retirar(tamano_proceso, tamano_asignado);
+    estadisticas.kb_usados -= tamano_proceso;
+    estadisticas.kb_asignados -= tamano_asignado;
+}
+
+/**
+ * Con memoria virtual, suma (signo 1) o resta (signo -1) una pagina de
+ * 'usado' KB que entra a un marco o sale de el
+ */
+void estadisticas_marco(int usado, int signo) {
+    estadisticas.kb_usados += signo * usado;
+    estadisticas.kb_asignados += signo * tamano_pagina;
+}
+
+/**
+ * Muestra las estadisticas de uso sin recorrer la tabla ni la memoria
+ */
+void mostrar_estadisticas(void) {
+    int k;
+    
+    PERFIL_ENTRAR(PERFIL_ESTADISTICAS);
+    printf("\n========== ESTADISTICAS DE MEMORIA ==========\n");
+    if (esquema_memoria == ESQUEMA_PARTICIONES) {
+        printf("Particiones ocupadas: %d de %d\n", estadisticas.procesos, num_particiones);
+    } else {
+        printf("Procesos en memoria: %d\n", estadisticas.procesos);
+    }
+    printf("Memoria usada: %ld KB de %d KB (%.2f%%)\n", estadisticas.kb_usados,
+           tamano_total_memoria,
+           tamano_total_memoria > 0 ? estadisticas.kb_usados * 100.0 / tamano_total_memoria : 0.0);
+    printf("Memoria asignada: %ld KB, desperdiciada: %ld KB\n", estadisticas.kb_asignados,
+           estadisticas.kb_asignados - estadisticas.kb_usados);
+    printf("Fragmentacion interna: total %.2f%%, promedio por proceso %.2f%%\n",
+           fragmentacion_interna_total(),
+           estadisticas.procesos > 0 ?
+           estadisticas.suma_fragmentacion / estadisticas.procesos : 0.0);
+    printf("Procesos admitidos: %ld\n", estadisticas.admitidos);
+    if (estadisticas.admitidos > 0) {
+        printf("%-24s %10s %8s\n", "Tamano (KB)", "Procesos", "%");
+        for (k = 0; k < NUM_CLASES; k++) {
+            if (estadisticas.histograma[k] > 0) {
+                printf("%10ld .. %-10ld %10ld %8.2f\n", 1L << k, (1L << (k + 1)) - 1,
+                       estadisticas.histograma[k],
+                       estadisticas.histograma[k] * 100.0 / estadisticas.admitidos);
+            }
+        }
+    }
+    printf("=============================================\n");
+    PERFIL_FIN(PERFIL_ESTADISTICAS);
+}
+
+/**
+ * Asigna una particion a un proceso nuevo con la politica de ubicacion
+ * activa. El proceso recibe el ID contador_procesos. Devuelve el indice de
+ * la particion asignada, -1 si no hay particion disponible o -2 si no hubo
+ * memoria para registrar el proceso
+ */
+int asignar_proceso(int tamano_proceso) {
+    int resultado;
+    
+    resultado = admitir_proceso(contador_procesos, tamano_proceso);
+    if (resultado >= 0) {
+        contador_procesos++;  /* Incrementar contador para el proximo proceso */
+    }
+    return resultado;
+}
+
+/**
+ * Carga en memoria el proceso 'id_proceso' con el motor activo, sin tocar
+ * contador_procesos (lo usa tambien la cola de espera, cuyos procesos ya
+ * tienen ID). Mismos valores de retorno que asignar_proceso()
+ */
+int admitir_proceso(int id_proceso, int tamano_proceso) {
+    int particion_asignada;
+    int dir_inicio;
+    Proceso *nuevo;
+    
+    PERFIL_ENTRAR(PERFIL_ADMITIR);
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        particion_asignada = asignar_dinamico(id_proceso, tamano_proceso);
+        
+        /* Si el proceso cabe en la memoria libre pero no en un hueco, se
+         * compacta cuando la fragmentacion externa alcanza el umbral */
+        if (particion_asignada == -1 && umbral_compactacion > 0.0 && tamano_proceso > 0 &&
+            tamano_proceso <= memoria_libre && fragmentacion_externa() >= umbral_compactacion) {
+            compactar_memoria();
+            compactaciones_automaticas++;
+            particion_asignada = asignar_dinamico(id_proceso, tamano_proceso);
+        }
+        if (particion_asignada >= 0) {
+            estadisticas_cargar(tamano_proceso, tamano_proceso);
+        }
+        return PERFIL_SALIR(PERFIL_ADMITIR, particion_asignada);
+    }
+    if (esquema_memoria == ESQUEMA_BUDDY) {
+        particion_asignada = asignar_buddy(id_proceso, tamano_proceso);
+        if (particion_asignada >= 0) {
+            estadisticas_cargar(tamano_proceso, 1 << particion_asignada);
+        }
+        return PERFIL_SALIR(PERFIL_ADMITIR, particion_asignada);
+    }
+    if (esquema_memoria == ESQUEMA_PAGINACION) {
+        particion_asignada = asignar_paginado(id_proceso, tamano_proceso);
+        if (particion_asignada >= 0 && politica_reemplazo != REEMPLAZO_NINGUNO) {
+            estadisticas_admitir(tamano_proceso, particion_asignada * tamano_pagina);
+        } else if (particion_asignada >= 0) {
+            estadisticas_cargar(tamano_proceso, particion_asignada * tamano_pagina);
+        }
+        return PERFIL_SALIR(PERFIL_ADMITIR, particion_asignada);
+    }
+    
+    particion_asignada = politica_actual->buscar(tamano_proceso);
+    if (particion_asignada == -1) {
+        return PERFIL_SALIR(PERFIL_ADMITIR, -1);
+    }
+    
+    /* Agregar proceso a la lista enlazada */
+    dir_inicio = tabla_particiones.direccion_inicio[particion_asignada];
+    nuevo = agregar_proceso(id_proceso, tamano_proceso, dir_inicio,
+                            particion_asignada);
+    if (nuevo == NULL) {
+        return PERFIL_SALIR(PERFIL_ADMITIR, -2);
+    }
+    
+    /* Asignar el proceso a la particion */
+    ocupar_particion(particion_asignada);
+    tabla_particiones.id_proceso[particion_asignada] = id_proceso;
+    tabla_particiones.tamano_usado[particion_asignada] = tamano_proceso;
+    tabla_particiones.proceso[particion_asignada] = nuevo;
+    ultima_asignada = particion_asignada;
+    estadisticas_cargar(tamano_proceso, tabla_particiones.tamano[particion_asignada]);
+    
+    /* Actualizar el vector de memoria con el ID del proceso */
+    if (memoria != NULL) {
+        llenar_celdas(memoria + dir_inicio, tamano_proceso, id_proceso);
+    }
+    return PERFIL_SALIR(PERFIL_ADMITIR, particion_asignada);
+}
+
+/**
+ * Libera la particion (o bloque) de un proceso y lo elimina de la tabla.
+ * Devuelve el indice de la particion liberada (en modo dinamico, el del
+ * hueco resultante; en modo buddy, la direccion del bloque libre
+ * resultante; en paginacion, los marcos liberados) o -1 si el proceso no
+ * existe
+ */
+int liberar_proceso(int id_proceso) {
+    Proceso *proceso;
+    int particion_encontrada;
+    int dir_inicio;
+    
+    /* Buscar el proceso en la lista */
+    PERFIL_ENTRAR(PERFIL_LIBERAR);
+    proceso = buscar_proceso(id_proceso);
+    if (proceso == NULL) {
+        return PERFIL_SALIR(PERFIL_LIBERAR, -1);
+    }
+    if (guardar_terminados) {
+        agregar_proceso_terminado(proceso->id, proceso->tamano_requerido,
+                                  proceso->direccion_asignada);
+    }
+    
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        if (memoria != NULL) {
+            llenar_celdas(memoria + proceso->direccion_asignada, proceso->tamano_requerido, -1);
+        }
+        estadisticas_liberar(proceso->tamano_requerido, proceso->tamano_requerido);
+        particion_encontrada = liberar_bloque(proceso->particion);
+        eliminar_proceso(id_proceso);
+        return PERFIL_SALIR(PERFIL_LIBERAR, particion_encontrada);
+    }
+    if (esquema_memoria == ESQUEMA_BUDDY) {
+        estadisticas_liberar(proceso->tamano_requerido, 1 << proceso->particion);
+        particion_encontrada = liberar_buddy(proceso);
+        eliminar_proceso(id_proceso);
+        return PERFIL_SALIR(PERFIL_LIBERAR, particion_encontrada);
+    }
+    if (esquema_memoria == ESQUEMA_PAGINACION) {
+        if (politica_reemplazo != REEMPLAZO_NINGUNO) {
+            estadisticas_retirar(proceso->tamano_requerido, proceso->particion * tamano_pagina);
+        } else {
+            estadisticas_liberar(proceso->tamano_requerido, proceso->particion * tamano_pagina);
+        }
+        particion_encontrada = liberar_paginado(proceso);
+        eliminar_proceso(id_proceso);
+        return PERFIL_SALIR(PERFIL_LIBERAR, particion_encontrada);
+    }
+    
+    /* La particion que contiene el proceso se conoce desde su creacion */
+    particion_encontrada = proceso->particion;
+    
+    /* Limpiar el vector de memoria: el proceso solo ocupa el prefijo usado
+     * de su particion, asi que basta un llenado incondicional de ese tramo */
+    dir_inicio = tabla_particiones.direccion_inicio[particion_encontrada];
+    if (memoria != NULL) {
+        llenar_celdas(memoria + dir_inicio,
+                      tabla_particiones.tamano_usado[particion_encontrada], -1);
+    }
+    
+    /* Liberar la particion */
+    estadisticas_liberar(proceso->tamano_requerido,
+                         tabla_particiones.tamano[particion_encontrada]);
+    desocupar_particion(particion_encontrada);
+    tabla_particiones.id_proceso[particion_encontrada] = -1;
+    tabla_particiones.tamano_usado[particion_encontrada] = 0;
+    tabla_particiones.proceso[particion_encontrada] = NULL;
+    
+    /* Eliminar el proceso de la lista enlazada */
+    eliminar_proceso(id_proceso);
+    return PERFIL_SALIR(PERFIL_LIBERAR, particion_encontrada);
+}
+
+/**
+ * Crea un nuevo proceso usando la politica de ubicacion activa
+ */
+void crear_proceso(void) {
+    int tamano_proceso;
+    int particion_asignada;
+    int id_proceso;
+    int prioridad;
+    float fragmentacion;
+    
+    /* Generar tamano aleatorio para el proceso (entre 1 y el tamano de particion) */
+    tamano_proceso = aleatorio_entre(1, tamano_particion);
+    id_proceso = contador_procesos;
+    prioridad = politica_cola == COLA_PRIORIDAD ? aleatorio_entre(1, PRIORIDAD_MAXIMA) : 1;
+    
+    printf("\n--- CREANDO NUEVO PROCESO ---\n");
+    printf("Proceso ID: %d\n", id_proceso);
+    printf("Tamano requerido: %d KB\n", tamano_proceso);
+    if (politica_cola == COLA_PRIORIDAD) {
+        printf("Prioridad: %d\n", prioridad);
+    }
+    
+    particion_asignada = solicitar_proceso(tamano_proceso, prioridad);
+    
+    if (particion_asignada == PROCESO_EN_COLA) {
+        printf(">>> SIN MEMORIA DISPONIBLE: PROCESO EN COLA DE ESPERA <<<\n");
+        printf("    Procesos en espera: %d\n", longitud_cola);
+        return;
+    }
+    
+    /* Verificar si se encontro una particion */
+    if (particion_asignada == -1) {
+        if (politica_cola != COLA_DESACTIVADA) {
+            printf("ERROR: El proceso no cabe en memoria y la cola no lo admite.\n");
+        } else {
+            printf("ERROR: No hay particiones disponibles para el proceso.\n");
+        }
+        printf("       El proceso no pudo ser creado.\n");
+        return;
+    }
+    if (particion_asignada < 0) {
+        printf("       El proceso no pudo ser creado.\n");
+        return;
+    }
+    
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        printf(">>> PROCESO CREADO EXITOSAMENTE <<<\n");
+        printf("    Asignado al bloque: %d\n", particion_asignada);
+        printf("    Direccion de inicio: %d\n", bloques[particion_asignada].inicio);
+        printf("    Fragmentacion externa: %.2f%%\n", fragmentacion_externa());
+        return;
+    }
+    if (esquema_memoria == ESQUEMA_BUDDY) {
+        printf(">>> PROCESO CREADO EXITOSAMENTE <<<\n");
+        printf("    Asignado a un bloque de %d KB (orden %d)\n",
+               1 << particion_asignada, particion_asignada);
+        printf("    Direccion de inicio: %d\n", buscar_proceso(id_proceso)->direccion_asignada);
+        printf("    Fragmentacion interna: %.2f%%\n",
+               calcular_fragmentacion(1 << particion_asignada, tamano_proceso));
+        return;
+    }
+    if (esquema_memoria == ESQUEMA_PAGINACION) {
+        printf(">>> PROCESO CREADO EXITOSAMENTE <<<\n");
+        if (politica_reemplazo != REEMPLAZO_NINGUNO) {
+            printf("    Paginas: %d de %d KB (se cargan al referenciarlas)\n",
+                   particion_asignada, tamano_pagina);
+        } else {
+            printf("    Paginas: %d de %d KB (primer marco: %d)\n", particion_asignada,
+                   tamano_pagina, buscar_proceso(id_proceso)->tabla_paginas[0]);
+        }
+        printf("    Fragmentacion interna: %.2f%%\n",
+               calcular_fragmentacion(particion_asignada * tamano_pagina, tamano_proceso));
+        return;
+    }
+    
+    /* Calcular fragmentacion interna */
+    fragmentacion = calcular_fragmentacion(tabla_particiones.tamano[particion_asignada],
+                                           tamano_proceso);
+    
+    printf(">>> PROCESO CREADO EXITOSAMENTE <<<\n");
+    printf("    Asignado a la particion: %d\n", particion_asignada);
+    printf("    Direccion de inicio: %d\n", 
+           tabla_particiones.direccion_inicio[particion_asignada]);
+    printf("    Fragmentacion interna: %.2f%%\n", fragmentacion);
+}
+
+/**
+ * Cierra un proceso y libera la particion (ver terminar_proceso)
+ */
+void cerrar_proceso(void) {
+    int id_proceso;
+    int particion_encontrada;
+    long atendidos;
+    
+    printf("\n--- CERRAR PROCESO ---\n");
+    printf("Ingrese el ID del proceso a cerrar: ");
+    scanf("%d", &id_proceso);
+    
+    /* Las admisiones desde la cola se informan durante el cierre */
+    atendidos = cola_atendidos;
+    particion_encontrada = terminar_proceso(id_proceso, 1);
+    if (particion_encontrada == PROCESO_EN_COLA) {
+        printf(">>> PROCESO %d RETIRADO DE LA COLA DE ESPERA <<<\n", id_proceso);
+        return;
+    }
+    if (particion_encontrada == -1) {
+        printf("ERROR: No existe un proceso con ID %d.\n", id_proceso);
+        return;
+    }
+    
+    printf(">>> PROCESO %d CERRADO EXITOSAMENTE <<<\n", id_proceso);
+    if (esquema_memoria == ESQUEMA_PAGINACION) {
+        printf("    %d marcos liberados; marcos libres: %d.\n",
+               particion_encontrada, num_marcos_libres);
+    } else if (esquema_memoria == ESQUEMA_PARTICIONES) {
+        printf("    Particion %d liberada.\n", particion_encontrada);
+    } else if (cola_atendidos != atendidos) {
+        /* El hueco pudo reutilizarse para los procesos de la cola */
+        printf("    Bloque liberado.\n");
+    } else if (esquema_memoria == ESQUEMA_DINAMICO) {
+        printf("    Bloque liberado; hueco resultante: %d (%d KB).\n",
+               particion_encontrada, bloques[particion_encontrada].tamano);
+    } else {
+        printf("    Bloque liberado; bloque libre resultante en la direccion %d.\n",
+               particion_encontrada);
+    }
+}
+
+/**
+ * Muestra la tabla de procesos activos
+ */
+void mostrar_tabla_procesos(void) {
+    Proceso *actual;
+    
+    PERFIL_ENTRAR(PERFIL_TABLA_PROCESOS);
+    printf("\n========== TABLA DE PROCESOS ==========\n");
+    printf("%-10s %-15s %-20s\n", "ID", "Tamano (KB)", "Direccion Inicio");
+    printf("--------------------------------------------------\n");
+    
+    if (lista_procesos == NULL) {
+        printf("No hay procesos activos.\n");
+    } else {
+        actual = lista_procesos;
+        while (actual != NULL) {
+            printf("%-10d %-15d %-20d\n", 
+                   actual->id, 
+                   actual->tamano_requerido, 
+                   actual->direccion_asignada);
+            actual = actual->siguiente;
+        }
+    }
+    printf("=======================================\n");
+    
+    if (politica_cola != COLA_DESACTIVADA) {
+        mostrar_cola();
+    }
+    PERFIL_FIN(PERFIL_TABLA_PROCESOS);
+}
+
+/**
+ * Agrega un proceso al final del historial de terminados
+ */
+void agregar_proceso_terminado(int id, int tamano, int direccion) {
+    Terminado *ampliado;
+    long capacidad;
+    
+    if (num_terminados == capacidad_terminados) {
+        capacidad = capacidad_terminados == 0 ? 64 : capacidad_terminados * 2;
+        /* Un historial restaurado vive en la instantanea: se copia al crecer */
+        if (terminados_en_instantanea) {
+            ampliado = (Terminado *)malloc(capacidad * sizeof(Terminado));
+            if (ampliado != NULL && num_terminados > 0) {
+                memcpy(ampliado, terminados, num_terminados * sizeof(Terminado));
+            }
+        } else {
+            ampliado = (Terminado *)realloc(terminados, capacidad * sizeof(Terminado));
+        }
+        if (ampliado == NULL) {
+            printf("Error: No se pudo asignar memoria para el proceso terminado.\n");
+            return;
+        }
+        terminados = ampliado;
+        capacidad_terminados = capacidad;
+        terminados_en_instantanea = 0;
+    }
+    terminados[num_terminados].id = id;
+    terminados[num_terminados].tamano = tamano;
+    terminados[num_terminados].direccion = direccion;
+    num_terminados++;
+}
+
+/**
+ * Muestra el historial de procesos terminados
+ */
+void mostrar_procesos_terminados(void) {
+    long i;
+    
+    PERFIL_ENTRAR(PERFIL_TERMINADOS);
+    printf("\n========== PROCESOS TERMINADOS ==========\n");
+    printf("%-10s %-15s %-20s\n", "ID", "Tamano (KB)", "Direccion Inicio");
+    printf("--------------------------------------------------\n");
+    
+    if (num_terminados == 0) {
+        printf("No hay procesos terminados.\n");
+    } else {
+        for (i = 0; i < num_terminados; i++) {
+            printf("%-10d %-15d %-20d\n",
+                   terminados[i].id,
+                   terminados[i].tamano,
+                   terminados[i].direccion);
+        }
+        printf("\nTotal de procesos terminados: %ld\n", num_terminados);
+    }
+    printf("=========================================\n");
+    PERFIL_FIN(PERFIL_TERMINADOS);
+}
+
+/**
+ * Porcentaje de la memoria asignada a procesos que estos no usan (en modo
+ * dinamico cada bloque mide lo pedido, asi que siempre es 0)
+ */
+float fragmentacion_interna_total(void) {
+    if (estadisticas.kb_asignados == 0) {
+        return 0.0;
+    }
+    return (float)((estadisticas.kb_asignados - estadisticas.kb_usados) * 100.0 /
+                   estadisticas.kb_asignados);
+}
+
+/**
+ * Muestra la tabla de particiones con fragmentacion
+ */
+void mostrar_tabla_particiones(void) {
+    int i;
+    char *estado_str;
+    Proceso *proc;
+    float frag;
+    
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        mostrar_tabla_bloques();
+        return;
+    }
+    if (esquema_memoria == ESQUEMA_BUDDY) {
+        mostrar_tabla_buddy();
+        return;
+    }
+    if (esquema_memoria == ESQUEMA_PAGINACION) {
+        mostrar_tabla_paginas();
+        return;
+    }
+    PERFIL_ENTRAR(PERFIL_TABLA_PARTICIONES);
+    printf("\n==================== TABLA DE PARTICIONES ====================\n");
+    printf("%-8s %-12s %-18s %-12s %-12s %-15s\n", 
+           "Part ID", "Estado", "Dir. Inicio (KB)", "Tamano (KB)", "ID Proceso", "Fragment. (%)");
+    printf("---------------------------------------------------------------\n");
+    
+    for (i = 0; i < num_particiones; i++) {
+        estado_str = !estado_particion(i) ? "Libre" : "Ocupada";
+        
+        if (estado_particion(i)) {
+            /* Calcular fragmentacion para particiones ocupadas */
+            proc = tabla_particiones.proceso[i];
+            frag = 0.0;
+            if (proc != NULL) {
+                frag = calcular_fragmentacion(tabla_particiones.tamano[i], 
+                                              proc->tamano_requerido);
+            }
+            
+            printf("%-8d %-12s %-18d %-12d %-12d %-15.2f\n",
+                   i,
+                   estado_str,
+                   tabla_particiones.direccion_inicio[i],
+                   tabla_particiones.tamano[i],
+                   tabla_particiones.id_proceso[i],
+                   frag);
+        } else {
+            printf("%-8d %-12s %-18d %-12d %-12s %-15s\n",
+                   i,
+                   estado_str,
+                   tabla_particiones.direccion_inicio[i],
+                   tabla_particiones.tamano[i],
+                   "---",
+                   "---");
+        }
+    }
+    printf("---------------------------------------------------------------\n");
+    printf("Fragmentacion interna total: %.2f%%   Fragmentacion externa: ---\n",
+           fragmentacion_interna_total());
+    mostrar_metricas_compactacion();
+    printf("===============================================================\n");
+    PERFIL_FIN(PERFIL_TABLA_PARTICIONES);
+}
+
+/**
+ * Muestra los bloques del sistema de companeros en orden de direccion
+ */
+void mostrar_tabla_buddy(void) {
+    Proceso **orden;
+    int direccion;
+    int k;
+    int siguiente;
+    int libres;
+    
+    PERFIL_ENTRAR(PERFIL_TABLA_PARTICIONES);
+    orden = procesos_por_direccion();
+    if (orden == NULL && procesos_en_indice > 0) {
+        printf("Error: No se pudo asignar memoria para la tabla.\n");
+        PERFIL_FIN(PERFIL_TABLA_PARTICIONES);
+        return;
+    }
+    
+    printf("\n================= TABLA DE BLOQUES (BUDDY) ===================\n");
+    printf("%-8s %-12s %-18s %-12s %-12s %-15s\n", 
+           "Orden", "Estado", "Dir. Inicio (KB)", "Tamano (KB)", "ID Proceso", "Fragment. (%)");
+    printf("---------------------------------------------------------------\n");
+    
+    siguiente = 0;
+    libres = 0;
+    for (direccion = 0; direccion < tamano_total_memoria; direccion += 1 << k) {
+        if (bloque_buddy_en(direccion, &k)) {
+            printf("%-8d %-12s %-18d %-12d %-12s %-15s\n",
+                   k, "Libre", direccion, 1 << k, "---", "---");
+            libres++;
+        } else {
+            printf("%-8d %-12s %-18d %-12d %-12d %-15.2f\n",
+                   k, "Ocupado", direccion, 1 << k, orden[siguiente]->id,
+                   calcular_fragmentacion(1 << k, orden[siguiente]->tamano_requerido));
+            siguiente++;
+        }
+    }
+    printf("---------------------------------------------------------------\n");
+    printf("Bloques libres: %d   Memoria libre: %ld KB   Mayor bloque libre: %d KB\n",
+           libres, tamano_total_memoria - buddy_asignado, mayor_bloque_buddy());
+    printf("Fragmentacion interna total: %.2f%%   Fragmentacion externa: %.2f%%\n",
+           fragmentacion_interna_total(), fragmentacion_externa());
+    printf("===============================================================\n");
+    
+    if (orden != NULL) {
+        free(orden);
+    }
+    PERFIL_FIN(PERFIL_TABLA_PARTICIONES);
+}
+
+/**
+ * Muestra los bloques del particionamiento dinamico en orden de direccion
+ */
+void mostrar_tabla_bloques(void) {
+    int bloque;
+    
+    PERFIL_ENTRAR(PERFIL_TABLA_PARTICIONES);
+    printf("\n================ TABLA DE BLOQUES (DINAMICA) =================\n");
+    printf("%-8s %-12s %-18s %-12s %-12s\n", 
+           "Bloque", "Estado", "Dir. Inicio (KB)", "Tamano (KB)", "ID Proceso");
+    printf("---------------------------------------------------------------\n");
+    
+    /* El bloque de la direccion 0 nunca se recicla: las fusiones conservan
+     * siempre el bloque de menor direccion */
+    for (bloque = 0; bloque != -1; bloque = bloques[bloque].siguiente) {
+        if (bloques[bloque].libre) {
+            printf("%-8d %-12s %-18d %-12d %-12s\n",
+                   bloque, "Hueco", bloques[bloque].inicio, bloques[bloque].tamano, "---");
+        } else {
+            printf("%-8d %-12s %-18d %-12d %-12d\n",
+                   bloque, "Ocupado", bloques[bloque].inicio, bloques[bloque].tamano,
+                   bloques[bloque].proceso->id);
+        }
+    }
+    printf("---------------------------------------------------------------\n");
+    printf("Huecos: %d   Memoria libre: %d KB   Mayor hueco: %d KB\n",
+           num_huecos, memoria_libre, mayor_hueco());
+    printf("Fragmentacion interna total: %.2f%%   Fragmentacion externa: %.2f%%\n",
+           fragmentacion_interna_total(), fragmentacion_externa());
+    mostrar_metricas_compactacion();
+    printf("===============================================================\n");
+    PERFIL_FIN(PERFIL_TABLA_PARTICIONES);
+}
+
+/**
+ * Muestra la tabla de paginas de cada proceso (sus primeros marcos) y el
+ * uso de los marcos y del TLB
+ */
+void mostrar_tabla_paginas(void) {
+    Proceso *actual;
+    int i;
+    
+    PERFIL_ENTRAR(PERFIL_TABLA_PARTICIONES);
+    printf("\n===================== TABLA DE PAGINAS =======================\n");
+    printf("%-8s %-12s %-10s %-15s %s\n", 
+           "ID", "Tamano (KB)", "Paginas", "Fragment. (%)", "Marcos");
+    printf("---------------------------------------------------------------\n");
+    
+    if (lista_procesos == NULL) {
+        printf("No hay procesos activos.\n");
+    }
+    for (actual = lista_procesos; actual != NULL; actual = actual->siguiente) {
+        printf("%-8d %-12d %-10d %-15.2f", actual->id, actual->tamano_requerido,
+               actual->particion,
+               calcular_fragmentacion(actual->particion * tamano_pagina,
+                                      actual->tamano_requerido));
+        for (i = 0; i < actual->particion && i < 6; i++) {
+            if (actual->tabla_paginas[i] == -1) {
+                printf(" -");
+            } else {
+                printf(" %d", actual->tabla_paginas[i]);
+            }
+        }
+        if (actual->particion > 6) {
+            printf(" ...");
+        }
+        printf("\n");
+    }
+    printf("---------------------------------------------------------------\n");
+    mostrar_metricas_paginacion();
+    printf("Fragmentacion interna total: %.2f%%   Fragmentacion externa: ---\n",
+           fragmentacion_interna_total());
+    printf("===============================================================\n");
+    PERFIL_FIN(PERFIL_TABLA_PARTICIONES);
+}
+
+/**
+ * Muestra los marcos libres, la tasa de aciertos del TLB y la memoria que
+ * ocupan las tablas de paginas (una entrada de un int por pagina)
+ */
+void mostrar_metricas_paginacion(void) {
+    long referencias;
+    long bytes_tablas;
+    
+    referencias = tlb_aciertos + tlb_fallos;
+    bytes_tablas = entradas_tablas * (long)sizeof(int);
+    printf("Marcos: %d de %d KB, %d libres\n", num_marcos, tamano_pagina, num_marcos_libres);
+    printf("TLB: %d entradas, %d vias (%d conjuntos)\n", tlb_entradas, tlb_vias, tlb_conjuntos);
+    printf("Referencias: %ld  Aciertos en TLB: %ld (%.2f%%)  Recorridos de tabla: %ld",
+           referencias, tlb_aciertos,
+           referencias > 0 ? 100.0 * tlb_aciertos / referencias : 0.0, tlb_fallos);
+    if (referencias_invalidas > 0) {
+        printf("  Invalidas: %ld", referencias_invalidas);
+    }
+    printf("\n");
+    printf("Tablas de paginas: %ld entradas, %ld bytes (%.3f%% de la memoria asignada)\n",
+           entradas_tablas, bytes_tablas,
+           estadisticas.kb_asignados > 0 ?
+           100.0 * bytes_tablas / (estadisticas.kb_asignados * 1024.0) : 0.0);
+    if (politica_reemplazo != REEMPLAZO_NINGUNO) {
+        printf("Reemplazo: %s  Fallos de pagina: %ld (%.2f%% de las referencias)  "
+               "Desalojos: %ld\n", nombres_reemplazo[politica_reemplazo], fallos_pagina,
+               referencias > 0 ? 100.0 * fallos_pagina / referencias : 0.0, desalojos);
+    }
+}
+
+/**
+ * Traduce una direccion virtual de un proceso pedida por el usuario
+ */
+void traducir_interactivo(void) {
+    int id_proceso;
+    long direccion;
+    long fisica;
+    int resultado;
+    
+    printf("\n--- TRADUCIR DIRECCION ---\n");
+    if (esquema_memoria != ESQUEMA_PAGINACION) {
+        printf("ERROR: La traduccion solo existe en el modo de paginacion.\n");
+        return;
+    }
+    printf("Ingrese el ID del proceso y la direccion virtual (KB): ");
+    if (scanf("%d %ld", &id_proceso, &direccion) != 2) {
+        printf("ERROR: Entrada invalida.\n");
+        return;
+    }
+    
+    resultado = traducir_direccion(id_proceso, direccion, &fisica);
+    if (resultado == -1) {
+        printf("ERROR: La direccion no pertenece a un proceso activo.\n");
+        return;
+    }
+    printf(">>> Pagina %ld, desplazamiento %ld -> marco %ld, direccion fisica %ld (%s)\n",
+           direccion / tamano_pagina, direccion % tamano_pagina, fisica / tamano_pagina,
+           fisica, resultado == 1 ? "acierto en TLB" : "fallo en TLB, tabla recorrida");
+}
+
+/**
+ * Escribe el bufer de la vista de memoria (o de una exportacion) con una
+ * sola llamada
+ */
+void salida_vaciar(void) {
+    if (en_salida > 0) {
+        if (fwrite(bufer_salida, 1, (size_t)en_salida,
+                   archivo_salida != NULL ? archivo_salida : stdout) != (size_t)en_salida) {
+            error_salida = 1;
+        }
+        en_salida = 0;
+    }
+}
+
+/**
+ * Agrega texto al bufer de la vista (vaciandolo si no cabe)
+ */
+void salida_texto(const char *texto, int largo) {
+    if (en_salida + largo > TAMANO_SALIDA) {
+        salida_vaciar();
+    }
+    memcpy(bufer_salida + en_salida, texto, (size_t)largo);
+    en_salida += largo;
+}
+
+/**
+ * Escribe un entero en decimal en 'destino', alineado a la izquierda en
+ * 'ancho' caracteres (como "%-*ld"), sin pasar por printf. Devuelve los
+ * caracteres escritos
+ */
+int formatear_entero(char *destino, long valor, int ancho) {
+    char digitos[24];
+    unsigned long resto;
+    int escritos;
+    int n;
+    
+    resto = valor < 0 ? 0UL - (unsigned long)valor : (unsigned long)valor;
+    n = 0;
+    do {
+        digitos[n++] = (char)('0' + resto % 10);
+        resto /= 10;
+    } while (resto != 0);
+    if (valor < 0) {
+        digitos[n++] = '-';
+    }
+    escritos = 0;
+    while (n > 0) {
+        destino[escritos++] = digitos[--n];
+    }
+    while (escritos < ancho) {
+        destino[escritos++] = ' ';
+    }
+    return escritos;
+}
+
+/**
+ * Agrega un entero al bufer de la vista (ver formatear_entero)
+ */
+void salida_entero(long valor, int ancho) {
+    if (en_salida + 24 + ancho > TAMANO_SALIDA) {
+        salida_vaciar();
+    }
+    en_salida += formatear_entero(bufer_salida + en_salida, valor, ancho);
+}
+
+/**
+ * Agrega una cadena terminada en '\0' al bufer
+ */
+void salida_cadena(const char *texto) {
+    salida_texto(texto, (int)strlen(texto));
+}
+
+/**
+ * Agrega un numero con dos decimales al bufer, sin pasar por printf.
+ * Los empates exactos se redondean al par, igual que "%.2f"
+ */
+void salida_decimal(double valor) {
+    double escalado;
+    double resto;
+    long centesimas;
+    char decimales[3];
+    
+    escalado = valor * 100.0;
+    centesimas = (long)escalado;
+    if ((double)centesimas > escalado) {
+        centesimas--;
+    }
+    resto = escalado - (double)centesimas;
+    if (resto > 0.5 || (resto == 0.5 && centesimas % 2 != 0)) {
+        centesimas++;
+    }
+    if (centesimas < 0) {
+        salida_texto("-", 1);
+        centesimas = -centesimas;
+    }
+    salida_entero(centesimas / 100, 0);
+    decimales[0] = '.';
+    decimales[1] = (char)('0' + centesimas / 10 % 10);
+    decimales[2] = (char)('0' + centesimas % 10);
+    salida_texto(decimales, 3);
+}
+
+/**
+ * Agrega 'cantidad' KB contiguos con el mismo contenido (-1 = libre o ID
+ * de proceso). En la vista de celdas la celda se formatea una sola vez y
+ * se copia; en la de tramos se une al tramo en curso si es igual
+ */
+void agregar_tramo(int valor, long cantidad) {
+    char celda[32];
+    int largo;
+    long parte;
+    
+    if (cantidad <= 0) {
+        return;
+    }
+    if (vista_memoria == VISTA_MAPA) {
+        /* Repartir el tramo entre los caracteres que toca */
+        while (cantidad > 0) {
+            parte = escala_mapa - celdas_emitidas % escala_mapa;
+            if (parte > cantidad) {
+                parte = cantidad;
+            }
+            if (valor != -1) {
+                mapa_ocupado += parte;
+            }
+            celdas_emitidas += parte;
+            cantidad -= parte;
+            if (celdas_emitidas % escala_mapa == 0) {
+                emitir_caracter_mapa(escala_mapa);
+            }
+        }
+        return;
+    }
+    if (vista_memoria == VISTA_TRAMOS) {
+        if (tramo_largo > 0 && valor == tramo_valor) {
+            tramo_largo += cantidad;
+            celdas_emitidas += cantidad;
+            return;
+        }
+        cerrar_tramo();
+        tramo_valor = valor;
+        tramo_inicio = celdas_emitidas;
+        tramo_largo = cantidad;
+        celdas_emitidas += cantidad;
+        return;
+    }
+    
+    /* Celda "[ -- ] " o "[P<id> ] ", con el ID alineado en 3 caracteres */
+    if (valor == -1) {
+        memcpy(celda, "[ -- ] ", 7);
+        largo = 7;
+    } else {
+        celda[0] = '[';
+        celda[1] = 'P';
+        largo = 2 + formatear_entero(celda + 2, valor, 3);
+        celda[largo++] = ']';
+        celda[largo++] = ' ';
+    }
+    while (cantidad-- > 0) {
+        if (celdas_emitidas % CELDAS_POR_LINEA == 0 && celdas_emitidas > 0) {
+            salida_texto("\n", 1);  /* Salto de linea cada 20 elementos */
+        }
+        salida_texto(celda, largo);
+        celdas_emitidas++;
+    }
+}
+
+/**
+ * Emite la linea del tramo en curso: direccion, contenido y KB
+ * ("P12 x 4096" o "-- x 100")
+ */
+void cerrar_tramo(void) {
+    if (tramo_largo == 0) {
+        return;
+    }
+    salida_entero(tramo_inicio, 12);
+    if (tramo_valor == -1) {
+        salida_texto("--", 2);
+    } else {
+        salida_texto("P", 1);
+        salida_entero(tramo_valor, 0);
+    }
+    salida_texto(" x ", 3);
+    salida_entero(tramo_largo, 0);
+    salida_texto("\n", 1);
+    tramo_largo = 0;
+}
+
+/**
+ * Emite el caracter del mapa que cubre los ultimos 'ancho' KB:
+ * '.' libre, '#' lleno, y '1'..'9' las decenas de porcentaje ocupado.
+ * Cada linea empieza con la direccion de su primer caracter
+ */
+void emitir_caracter_mapa(long ancho) {
+    long caracter;
+    int decenas;
+    char simbolo;
+    
+    caracter = (celdas_emitidas - 1) / escala_mapa;
+    if (caracter % CARACTERES_MAPA == 0) {
+        if (caracter > 0) {
+            salida_texto("\n", 1);
+        }
+        salida_entero(caracter * escala_mapa, 12);
+    }
+    if (mapa_ocupado == 0) {
+        simbolo = '.';
+    } else if (mapa_ocupado >= ancho) {
+        simbolo = '#';
+    } else {
+        decenas = (int)(10.0 * mapa_ocupado / ancho);
+        simbolo = (char)('0' + (decenas < 1 ? 1 : decenas > 9 ? 9 : decenas));
+    }
+    salida_texto(&simbolo, 1);
+    mapa_ocupado = 0;
+}
+
+/**
+ * Recorre la memoria en orden de direccion entregando tramos de KB
+ * iguales a agregar_tramo(). Sin vector de memoria, o fuera de la vista
+ * de celdas, se reconstruyen a partir de las particiones o bloques, asi
+ * que el costo depende de su numero y no del tamano de la memoria
+ */
+void recorrer_memoria(void) {
+    int i;
+    int j;
+    int k;
+    int posicion;
+    int siguiente;
+    int libre;
+    Proceso **orden;
+    
+    PERFIL_ENTRAR(PERFIL_VISTA_MEMORIA);
+    celdas_emitidas = 0;
+    tramo_largo = 0;
+    mapa_ocupado = 0;
+    if (memoria != NULL && vista_memoria == VISTA_CELDAS) {
+        for (i = 0; i < tamano_total_memoria; i = j) {
+            j = i + 1;
+            while (j < tamano_total_memoria && memoria[j] == memoria[i]) {
+                j++;
+            }
+            agregar_tramo(memoria[i], j - i);
+        }
+    } else if (esquema_memoria == ESQUEMA_DINAMICO) {
+        /* Bloques en orden de direccion */
+        for (i = 0; i != -1; i = bloques[i].siguiente) {
+            agregar_tramo(bloques[i].libre ? -1 : bloques[i].proceso->id, bloques[i].tamano);
+        }
+    } else if (esquema_memoria == ESQUEMA_BUDDY) {
+        /* Bloques de companeros en orden de direccion */
+        orden = procesos_por_direccion();
+        siguiente = 0;
+        for (i = 0; i < tamano_total_memoria; i += 1 << k) {
+            libre = bloque_buddy_en(i, &k) || orden == NULL;
+            if (libre) {
+                agregar_tramo(-1, 1L << k);
+            } else {
+                agregar_tramo(orden[siguiente]->id, orden[siguiente]->tamano_requerido);
+                agregar_tramo(-1, (1L << k) - orden[siguiente]->tamano_requerido);
+                siguiente++;
+            }
+        }
+        if (orden != NULL) {
+            free(orden);
+        }
+    } else if (esquema_memoria == ESQUEMA_PAGINACION) {
+        /* Marcos en orden, con los KB que sobran al final libres */
+        for (i = 0; i < num_marcos; i++) {
+            agregar_tramo(marco_proceso[i], marco_usado[i]);
+            agregar_tramo(-1, tamano_pagina - marco_usado[i]);
+        }
+        agregar_tramo(-1, tamano_total_memoria - (long)num_marcos * tamano_pagina);
+    } else {
+        /* Extension ocupada de cada particion y el resto libre */
+        posicion = 0;
+        for (i = 0; i < num_particiones; i++) {
+            agregar_tramo(tabla_particiones.tamano_usado[i] > 0 ?
+                          tabla_particiones.id_proceso[i] : -1,
+                          tabla_particiones.tamano_usado[i]);
+            agregar_tramo(-1, tabla_particiones.tamano[i] - tabla_particiones.tamano_usado[i]);
+            posicion += tabla_particiones.tamano[i];
+        }
+        agregar_tramo(-1, tamano_total_memoria - posicion);
+    }
+    if (vista_memoria == VISTA_TRAMOS) {
+        cerrar_tramo();
+    } else if (vista_memoria == VISTA_MAPA && celdas_emitidas % escala_mapa != 0) {
+        emitir_caracter_mapa(celdas_emitidas % escala_mapa);
+    }
+    salida_vaciar();
+    PERFIL_FIN(PERFIL_VISTA_MEMORIA);
+}
+
+/**
+ * Muestra visualmente el vector de memoria
+ */
+void mostrar_memoria(void) {
+    printf("\n========== VISUALIZACION DE MEMORIA ==========\n");
+    printf("Leyenda: [-1] = Libre, [N] = Proceso ID N\n");
+    printf("----------------------------------------------\n");
+    
+    vista_memoria = VISTA_CELDAS;
+    recorrer_memoria();
+    
+    printf("\n==============================================\n");
+}
+
+/**
+ * Muestra la memoria comprimida: una linea por tramo de KB contiguos con
+ * el mismo contenido, con su direccion de inicio
+ */
+void mostrar_memoria_tramos(void) {
+    printf("\n========== MEMORIA POR TRAMOS ==========\n");
+    printf("Leyenda: -- = Libre, PN = Proceso ID N, x = KB del tramo\n");
+    printf("%-12s%s\n", "Direccion", "Contenido");
+    printf("----------------------------------------\n");
+    
+    vista_memoria = VISTA_TRAMOS;
+    recorrer_memoria();
+    
+    printf("========================================\n");
+}
+
+/**
+ * Muestra un mapa de toda la memoria en el que cada caracter resume
+ * 'escala' KB. Con escala 0 se elige la que deja el mapa en 16 lineas
+ */
+void mostrar_mapa_memoria(void) {
+    long escala;
+    
+    printf("\n--- MAPA DE MEMORIA ---\n");
+    printf("KB por caracter (0 = automatico): ");
+    if (scanf("%ld", &escala) != 1 || escala < 0) {
+        printf("ERROR: Escala invalida.\n");
+        return;
+    }
+    if (escala == 0) {
+        escala = ((long)tamano_total_memoria + CARACTERES_MAPA * LINEAS_MAPA - 1) /
+                 (CARACTERES_MAPA * LINEAS_MAPA);
+        if (escala < 1) {
+            escala = 1;
+        }
+    }
+    
+    printf("\n========== MAPA DE MEMORIA ==========\n");
+    printf("Escala: %ld KB por caracter, %d caracteres por linea\n", escala, CARACTERES_MAPA);
+    printf("Leyenda: . = Libre, 1-9 = Decenas de %% ocupado, # = Lleno\n");
+    printf("%-12s%s\n", "Direccion", "Ocupacion");
+    printf("-------------------------------------\n");
+    
+    escala_mapa = escala;
+    vista_memoria = VISTA_MAPA;
+    recorrer_memoria();
+    
+    printf("\n=====================================\n");
+}
+
+/**
+ * Libera todo el estado del simulador y lo deja listo para reconfigurarse
+ */
+void destruir_estado(void) {
+    int i;
+    Proceso *actual;
+    
+    /* Liberar lista de procesos (todos los nodos viven en el pool) y sus
+     * tablas de paginas */
+    for (actual = lista_procesos; actual != NULL; actual = actual->siguiente) {
+        if (actual->tabla_paginas != NULL) {
+            free(actual->tabla_paginas);
+        }
+    }
+    pool_destruir();
+    lista_procesos = NULL;
+    ultimo_proceso = NULL;
+    if (indice_procesos != NULL) {
+        free(indice_procesos);
+    }
+    indice_procesos = NULL;
+    capacidad_indice = 0;
+    procesos_en_indice = 0;
+    
+    /* Liberar vector de memoria y tabla de particiones */
+    if (memoria != NULL) {
+        free(memoria);
+    }
+    destruir_tabla_particiones();
+    memoria = NULL;
+    mapa_destruir(&mapa_libres);
+    
+    /* Liberar los indices de particiones variables */
+    if (orden_por_tamano != NULL) {
+        free(orden_por_tamano);
+    }
+    if (rango_por_tamano != NULL) {
+        free(rango_por_tamano);
+    }
+    if (tamanos_ordenados != NULL) {
+        free(tamanos_ordenados);
+    }
+    if (arbol_libres != NULL) {
+        free(arbol_libres);
+    }
+    orden_por_tamano = NULL;
+    rango_por_tamano = NULL;
+    tamanos_ordenados = NULL;
+    arbol_libres = NULL;
+    hojas_arbol = 0;
+    mapa_destruir(&mapa_por_tamano);
+    particiones_variables = 0;
+    ultima_asignada = -1;
+    
+    /* Liberar los bloques del modo dinamico */
+    if (bloques != NULL) {
+        free(bloques);
+    }
+    bloques = NULL;
+    capacidad_bloques = 0;
+    bloques_sin_uso = -1;
+    num_bloques = 0;
+    num_huecos = 0;
+    memoria_libre = 0;
+    compactaciones = 0;
+    compactaciones_automaticas = 0;
+    kb_compactados = 0;
+    ns_compactacion = 0.0;
+    ns_ultima_compactacion = 0.0;
+    
+    /* Liberar los mapas del sistema de companeros */
+    for (i = 0; i < ORDENES_BUDDY; i++) {
+        mapa_destruir(&buddy_libres[i]);
+        mapa_destruir(&buddy_ocupados[i]);
+        buddy_num_libres[i] = 0;
+    }
+    ordenes_libres = 0;
+    buddy_asignado = 0;
+    buddy_usado = 0;
+    
+    /* Liberar los marcos y el TLB de la paginacion */
+    if (marcos_libres != NULL) {
+        free(marcos_libres);
+    }
+    if (marco_proceso != NULL) {
+        free(marco_proceso);
+    }
+    if (marco_usado != NULL) {
+        free(marco_usado);
+    }
+    if (tlb != NULL) {
+        free(tlb);
+    }
+    reemplazo_destruir();
+    marcos_libres = NULL;
+    marco_proceso = NULL;
+    marco_usado = NULL;
+    tlb = NULL;
+    num_marcos = 0;
+    num_marcos_libres = 0;
+    tamano_pagina = 0;
+    entradas_tablas = 0;
+    esquema_memoria = ESQUEMA_PARTICIONES;
+    memset(&estadisticas, 0, sizeof(Estadisticas));
+    
+    /* Liberar el historial de terminados y la instantanea cargada */
+    if (!terminados_en_instantanea) {
+        free(terminados);
+    }
+    terminados = NULL;
+    num_terminados = 0;
+    capacidad_terminados = 0;
+    terminados_en_instantanea = 0;
+    liberar_instantanea();
+    
+    /* Liberar los procesos en espera y los eventos de la simulacion */
+    vaciar_cola();
+    if (eventos != NULL) {
+        free(eventos);
+    }
+    if (llegada_sim != NULL) {
+        free(llegada_sim);
+    }
+    if (duracion_sim != NULL) {
+        free(duracion_sim);
+    }
+    eventos = NULL;
+    num_eventos = 0;
+    capacidad_eventos = 0;
+    secuencia_eventos = 0;
+    llegada_sim = NULL;
+    duracion_sim = NULL;
+    capacidad_sim = 0;
+    
+    num_particiones = 0;
+    tamano_total_memoria = 0;
+    tamano_particion = 0;
+    contador_procesos = 1;
+}
+
+/**
+ * Libera toda la memoria asignada dinamicamente
+ */
+void liberar_recursos(void) {
+#if defined(PERFILADO)
+    mostrar_perfil();
+#endif
+    destruir_estado();
+    
+    printf("\n>>> Recursos liberados. Programa finalizado.\n");
+}
+
+/* ==================== COLA DE ESPERA ==================== */
+
+/**
+ * Mayor tamano que podria llegar a caber con la memoria vacia
+ */
+int tamano_maximo_admisible(void) {
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        return tamano_total_memoria;
+    }
+    if (esquema_memoria == ESQUEMA_BUDDY) {
+        return 1 << ultimo_bit((unsigned long)tamano_total_memoria);
+    }
+    if (esquema_memoria == ESQUEMA_PAGINACION) {
+        return politica_reemplazo != REEMPLAZO_NINGUNO ? INT_MAX : num_marcos * tamano_pagina;
+    }
+    return tamano_particion;
+}
+
+/**
+ * Avanza el reloj de operaciones y acumula la longitud de la cola
+ */
+void avanzar_reloj(void) {
+    reloj_operaciones++;
+    cola_profundidad_acumulada += longitud_cola;
+}
+
+/**
+ * Reserva un bloque de 'cantidad' nodos de la cola y los encadena a la
+ * lista de libres
+ */
+int pendientes_crecer(int cantidad) {
+    BloquePendientes *bloque;
+    int i;
+    
+    if (cantidad < 16) {
+        cantidad = 16;
+    }
+    bloque = (BloquePendientes *)malloc(sizeof(BloquePendientes) + cantidad * sizeof(Pendiente));
+    if (bloque == NULL) {
+        return 0;
+    }
+    bloque->nodos = (Pendiente *)(bloque + 1);
+    bloque->capacidad = cantidad;
+    bloque->siguiente = bloques_pendientes;
+    bloques_pendientes = bloque;
+    for (i = 0; i < cantidad; i++) {
+        bloque->nodos[i].siguiente = pendientes_libres;
+        pendientes_libres = &bloque->nodos[i];
+    }
+    return 1;
+}
+
+/**
+ * Cambia el tamano de una ranura del arbol de minimos (INT_MAX = vacia) y
+ * actualiza sus ancestros
+ */
+void arbol_cola_actualizar(int ranura, int valor) {
+    int nodo;
+    int minimo;
+    
+    nodo = hojas_cola + ranura;
+    arbol_cola[nodo] = valor;
+    for (nodo /= 2; nodo >= 1; nodo /= 2) {
+        minimo = arbol_cola[2 * nodo] < arbol_cola[2 * nodo + 1] ?
+                 arbol_cola[2 * nodo] : arbol_cola[2 * nodo + 1];
+        if (arbol_cola[nodo] == minimo) {
+            break;  /* Los ancestros ya no cambian */
+        }
+        arbol_cola[nodo] = minimo;
+    }
+}
+
+/**
+ * Primera ranura con indice >= desde y tamano < limite en el subarbol
+ * 'nodo' que cubre [izq, der], o -1. Solo desciende por ramas que sirven
+ */
+int arbol_cola_buscar(int nodo, int izq, int der, int desde, int limite) {
+    int medio;
+    int resultado;
+    
+    PERFIL_CONTAR(perfil_nodos);
+    if (der < desde || arbol_cola[nodo] >= limite) {
+        return -1;
+    }
+    if (izq == der) {
+        return izq;
+    }
+    medio = (izq + der) / 2;
+    resultado = arbol_cola_buscar(2 * nodo, izq, medio, desde, limite);
+    if (resultado == -1) {
+        resultado = arbol_cola_buscar(2 * nodo + 1, medio + 1, der, desde, limite);
+    }
+    return resultado;
+}
+
+/**
+ * Se llamo al agotar las ranuras: pasa los procesos en espera, en el mismo
+ * orden, al principio de un arreglo con al menos el doble de ranuras que
+ * procesos y reconstruye el arbol. Devuelve 0 si falta memoria
+ */
+int reubicar_ranuras(void) {
+    Pendiente **ranuras_nuevas;
+    int *arbol_nuevo;
+    int hojas;
+    int usadas;
+    int i;
+    
+    hojas = 16;
+    while (hojas < 2 * (longitud_cola + 1)) {
+        hojas *= 2;
+    }
+    ranuras_nuevas = (Pendiente **)malloc(hojas * sizeof(Pendiente *));
+    arbol_nuevo = (int *)malloc(2 * hojas * sizeof(int));
+    if (ranuras_nuevas == NULL || arbol_nuevo == NULL) {
+        free(ranuras_nuevas);
+        free(arbol_nuevo);
+        return 0;
+    }
+    
+    usadas = 0;
+    for (i = cabeza_cola; i < ranuras_usadas; i++) {
+        if (cola_ranuras[i] != NULL) {
+            cola_ranuras[i]->ranura = usadas;
+            ranuras_nuevas[usadas++] = cola_ranuras[i];
+        }
+    }
+    for (i = 0; i < hojas; i++) {
+        arbol_nuevo[hojas + i] = i < usadas ? ranuras_nuevas[i]->tamano : INT_MAX;
+    }
+    for (i = hojas - 1; i >= 1; i--) {
+        arbol_nuevo[i] = arbol_nuevo[2 * i] < arbol_nuevo[2 * i + 1] ?
+                         arbol_nuevo[2 * i] : arbol_nuevo[2 * i + 1];
+    }
+    
+    free(cola_ranuras);
+    free(arbol_cola);
+    cola_ranuras = ranuras_nuevas;
+    arbol_cola = arbol_nuevo;
+    hojas_cola = hojas;
+    ranuras_usadas = usadas;
+    cabeza_cola = 0;
+    return 1;
+}
+
+/**
+ * Orden de atencion por prioridad: mayor prioridad primero y, a igual
+ * prioridad, el que llego antes (las ranuras conservan el orden de llegada)
+ */
+int pendiente_antes(const Pendiente *a, const Pendiente *b) {
+    return a->prioridad > b->prioridad ||
+           (a->prioridad == b->prioridad && a->ranura < b->ranura);
+}
+
+/**
+ * Deja un proceso en una posicion del monticulo
+ */
+void monticulo_colocar(Pendiente *pendiente, int posicion) {
+    monticulo_cola[posicion] = pendiente;
+    pendiente->en_monticulo = posicion;
+}
+
+/**
+ * Sube un elemento del monticulo mientras vaya antes que su padre
+ */
+void monticulo_subir(int posicion) {
+    Pendiente *pendiente;
+    int padre;
+    
+    pendiente = monticulo_cola[posicion];
+    while (posicion > 0) {
+        padre = (posicion - 1) / 2;
+        if (!pendiente_antes(pendiente, monticulo_cola[padre])) {
+            break;
+        }
+        monticulo_colocar(monticulo_cola[padre], posicion);
+        posicion = padre;
+    }
+    monticulo_colocar(pendiente, posicion);
+}
+
+/**
+ * Baja un elemento del monticulo mientras algun hijo vaya antes que el
+ */
+void monticulo_bajar(int posicion) {
+    Pendiente *pendiente;
+    int hijo;
+    
+    pendiente = monticulo_cola[posicion];
+    for (;;) {
+        hijo = 2 * posicion + 1;
+        if (hijo >= longitud_cola) {
+            break;
+        }
+        if (hijo + 1 < longitud_cola &&
+            pendiente_antes(monticulo_cola[hijo + 1], monticulo_cola[hijo])) {
+            hijo++;
+        }
+        if (!pendiente_antes(monticulo_cola[hijo], pendiente)) {
+            break;
+        }
+        monticulo_colocar(monticulo_cola[hijo], posicion);
+        posicion = hijo;
+    }
+    monticulo_colocar(pendiente, posicion);
+}
+
+/**
+ * Reconstruye el monticulo en O(n) si se dejo de mantener mientras la
+ * politica no era por prioridad
+ */
+void preparar_monticulo(void) {
+    int posicion;
+    int i;
+    
+    if (monticulo_al_dia) {
+        return;
+    }
+    posicion = 0;
+    for (i = cabeza_cola; i < ranuras_usadas; i++) {
+        if (cola_ranuras[i] != NULL) {
+            monticulo_colocar(cola_ranuras[i], posicion++);
+        }
+    }
+    for (i = longitud_cola / 2 - 1; i >= 0; i--) {
+        monticulo_bajar(i);
+    }
+    monticulo_al_dia = 1;
+}
+
+/**
+ * Duplica las cubetas del indice por ID de la cola y redistribuye los
+ * procesos en espera. Devuelve 0 si falta memoria
+ */
+int agrandar_indice_cola(void) {
+    Pendiente **cubetas;
+    Pendiente *actual;
+    Pendiente *siguiente;
+    unsigned long cubeta;
+    int nuevas;
+    int i;
+    
+    nuevas = cubetas_cola == 0 ? 16 : cubetas_cola * 2;
+    cubetas = (Pendiente **)calloc(nuevas, sizeof(Pendiente *));
+    if (cubetas == NULL) {
+        return 0;
+    }
+    for (i = 0; i < cubetas_cola; i++) {
+        for (actual = indice_cola[i]; actual != NULL; actual = siguiente) {
+            siguiente = actual->siguiente;
+            cubeta = ((unsigned long)actual->id * 2654435761UL) & (unsigned long)(nuevas - 1);
+            actual->siguiente = cubetas[cubeta];
+            cubetas[cubeta] = actual;
+        }
+    }
+    free(indice_cola);
+    indice_cola = cubetas;
+    cubetas_cola = nuevas;
+    return 1;
+}
+
+/**
+ * Proceso en espera con ese ID, o NULL
+ */
+Pendiente* buscar_pendiente(int id_proceso) {
+    Pendiente *actual;
+    
+    if (cubetas_cola == 0) {
+        return NULL;
+    }
+    actual = indice_cola[((unsigned long)id_proceso * 2654435761UL) &
+                         (unsigned long)(cubetas_cola - 1)];
+    while (actual != NULL && actual->id != id_proceso) {
+        PERFIL_CONTAR(perfil_nodos);
+        actual = actual->siguiente;
+    }
+    return actual;
+}
+
+/**
+ * Proximo proceso a atender con FIFO (el que llego antes) o por prioridad
+ * (la cima del monticulo), o NULL si la cola esta vacia
+ */
+Pendiente* primero_de_cola(void) {
+    if (longitud_cola == 0) {
+        return NULL;
+    }
+    if (politica_cola == COLA_PRIORIDAD) {
+        preparar_monticulo();
+        return monticulo_cola[0];
+    }
+    while (cola_ranuras[cabeza_cola] == NULL) {
+        cabeza_cola++;
+    }
+    return cola_ranuras[cabeza_cola];
+}
+
+/**
+ * Compara dos procesos en espera por orden de atencion (para qsort)
+ */
+int comparar_pendientes(const void *a, const void *b) {
+    const Pendiente *x;
+    const Pendiente *y;
+    
+    x = *(const Pendiente * const *)a;
+    y = *(const Pendiente * const *)b;
+    if (pendiente_antes(x, y)) {
+        return -1;
+    }
+    return pendiente_antes(y, x) ? 1 : 0;
+}
+
+/**
+ * Agrega un proceso a la cola. Queda en la siguiente ranura por orden de
+ * llegada, en el indice por ID y, con la politica por prioridad, en el
+ * monticulo, cada uno en O(log n) o menos. Devuelve 0 si la cola esta
+ * llena o no hubo memoria
+ */
+int encolar_proceso(int id_proceso, int tamano, int prioridad) {
+    Pendiente **ampliado;
+    Pendiente *nuevo;
+    unsigned long cubeta;
+    int capacidad;
+    
+    if (capacidad_cola > 0 && longitud_cola >= capacidad_cola) {
+        return 0;
+    }
+    if ((pendientes_libres == NULL && !pendientes_crecer(longitud_cola)) ||
+        (ranuras_usadas == hojas_cola && !reubicar_ranuras()) ||
+        (longitud_cola >= cubetas_cola && !agrandar_indice_cola())) {
+        return 0;
+    }
+    if (longitud_cola == capacidad_monticulo) {
+        capacidad = capacidad_monticulo == 0 ? 16 : capacidad_monticulo * 2;
+        ampliado = (Pendiente **)realloc(monticulo_cola, capacidad * sizeof(Pendiente *));
+        if (ampliado == NULL) {
+            return 0;
+        }
+        monticulo_cola = ampliado;
+        capacidad_monticulo = capacidad;
+    }
+    if (politica_cola == COLA_PRIORIDAD) {
+        preparar_monticulo();
+    }
+    
+    nuevo = pendientes_libres;
+    pendientes_libres = nuevo->siguiente;
+    nuevo->id = id_proceso;
+    nuevo->tamano = tamano;
+    nuevo->prioridad = prioridad;
+    nuevo->llegada = reloj_operaciones;
+    nuevo->ranura = ranuras_usadas++;
+    cola_ranuras[nuevo->ranura] = nuevo;
+    arbol_cola_actualizar(nuevo->ranura, tamano);
+    cubeta = ((unsigned long)id_proceso * 2654435761UL) & (unsigned long)(cubetas_cola - 1);
+    nuevo->siguiente = indice_cola[cubeta];
+    indice_cola[cubeta] = nuevo;
+    if (politica_cola == COLA_PRIORIDAD) {
+        monticulo_colocar(nuevo, longitud_cola);
+        longitud_cola++;
+        monticulo_subir(nuevo->en_monticulo);
+    } else {
+        monticulo_al_dia = 0;
+        longitud_cola++;
+    }
+    
+    cola_encolados++;
+    if (longitud_cola > cola_profundidad_maxima) {
+        cola_profundidad_maxima = longitud_cola;
+    }
+    return 1;
+}
+
+/**
+ * Saca un proceso de la cola (ranura, monticulo e indice) y devuelve su
+ * nodo al pool
+ */
+void quitar_de_cola(Pendiente *pendiente) {
+    Pendiente **enlace;
+    Pendiente *ultimo;
+    
+    cola_ranuras[pendiente->ranura] = NULL;
+    arbol_cola_actualizar(pendiente->ranura, INT_MAX);
+    
+    enlace = &indice_cola[((unsigned long)pendiente->id * 2654435761UL) &
+                          (unsigned long)(cubetas_cola - 1)];
+    while (*enlace != pendiente) {
+        enlace = &(*enlace)->siguiente;
+    }
+    *enlace = pendiente->siguiente;
+    
+    /* El ultimo del monticulo ocupa su lugar y se reacomoda */
+    longitud_cola--;
+    if (politica_cola != COLA_PRIORIDAD) {
+        monticulo_al_dia = 0;
+    } else if (monticulo_al_dia) {
+        ultimo = monticulo_cola[longitud_cola];
+        if (ultimo != pendiente) {
+            monticulo_colocar(ultimo, pendiente->en_monticulo);
+            monticulo_subir(ultimo->en_monticulo);
+            monticulo_bajar(ultimo->en_monticulo);
+        }
+    }
+    
+    pendiente->siguiente = pendientes_libres;
+    pendientes_libres = pendiente;
+}
+
+/**
+ * Retira de la cola al proceso con ese ID. Devuelve 1 si estaba esperando
+ */
+int cancelar_pendiente(int id_proceso) {
+    Pendiente *pendiente;
+    
+    pendiente = buscar_pendiente(id_proceso);
+    if (pendiente == NULL) {
+        return 0;
+    }
+    quitar_de_cola(pendiente);
+    cola_cancelados++;
+    return 1;
+}
+
+/**
+ * Admite procesos de la cola mientras quepan. FIFO y prioridad solo
+ * intentan con el primero de la cola (sin adelantamientos). Por tamano se
+ * avanza en orden de llegada sin reintentar tamanos mayores o iguales a
+ * uno que ya fallo: el arbol de minimos salta directo al siguiente menor,
+ * asi que solo se visitan los procesos que se intentan admitir. Devuelve
+ * la cantidad de procesos admitidos
+ */
+int drenar_cola(int informar) {
+    Pendiente *actual;
+    int admitidos;
+    int menor_fallido;
+    int desde;
+    int ranura;
+    long espera;
+    
+    admitidos = 0;
+    menor_fallido = INT_MAX;
+    desde = 0;
+    while (longitud_cola > 0) {
+        if (politica_cola == COLA_TAMANO) {
+            ranura = arbol_cola_buscar(1, 0, hojas_cola - 1, desde, menor_fallido);
+            if (ranura == -1) {
+                break;
+            }
+            actual = cola_ranuras[ranura];
+        } else {
+            actual = primero_de_cola();
+        }
+        desde = actual->ranura + 1;
+        if (admitir_proceso(actual->id, actual->tamano) >= 0) {
+            espera = reloj_operaciones - actual->llegada;
+            cola_espera_total += espera;
+            if (espera > cola_espera_maxima) {
+                cola_espera_maxima = espera;
+            }
+            cola_atendidos++;
+            admitidos++;
+            if (al_admitir_desde_cola != NULL) {
+                al_admitir_desde_cola(actual->id);
+            }
+            if (informar) {
+                printf("    Proceso %d admitido desde la cola (espero %ld operaciones).\n",
+                       actual->id, espera);
+            }
+            quitar_de_cola(actual);
+        } else if (politica_cola != COLA_TAMANO) {
+            break;
+        } else {
+            menor_fallido = actual->tamano;
+            if (menor_fallido == 1) {
+                break;
+            }
+        }
+    }
+    return admitidos;
+}
+
+/**
+ * Crea un proceso de 'tamano_proceso' KB con el ID contador_procesos. Si no
+ * cabe y la cola esta activa queda en espera y devuelve PROCESO_EN_COLA.
+ * Con FIFO o prioridad los recien llegados no adelantan a los que ya
+ * esperan. Devuelve -1 si no cabe y la cola esta desactivada, llena o el
+ * proceso es mayor que la memoria (no cabria nunca); en otro caso lo mismo
+ * que asignar_proceso()
+ */
+int solicitar_proceso(int tamano_proceso, int prioridad) {
+    int resultado;
+    int id_proceso;
+    Proceso *admitido;
+    
+    PERFIL_ENTRAR(PERFIL_CREAR);
+    avanzar_reloj();
+    if (politica_cola == COLA_DESACTIVADA) {
+        resultado = asignar_proceso(tamano_proceso);
+        return PERFIL_SALIR(PERFIL_CREAR, resultado);
+    }
+    
+    if (longitud_cola == 0 || politica_cola == COLA_TAMANO) {
+        resultado = asignar_proceso(tamano_proceso);
+        if (resultado != -1) {
+            return PERFIL_SALIR(PERFIL_CREAR, resultado);
+        }
+    }
+    
+    id_proceso = contador_procesos;
+    if (tamano_proceso > tamano_maximo_admisible() ||
+        !encolar_proceso(id_proceso, tamano_proceso, prioridad)) {
+        cola_rechazados++;
+        return PERFIL_SALIR(PERFIL_CREAR, -1);
+    }
+    contador_procesos++;
+    
+    /* Con prioridad el recien llegado puede haber quedado primero y caber */
+    if (politica_cola == COLA_PRIORIDAD && primero_de_cola()->id == id_proceso) {
+        drenar_cola(0);
+        admitido = buscar_proceso(id_proceso);
+        if (admitido != NULL) {
+            return PERFIL_SALIR(PERFIL_CREAR, admitido->particion);
+        }
+    }
+    return PERFIL_SALIR(PERFIL_CREAR, PROCESO_EN_COLA);
+}
+
+/**
+ * Cierra un proceso (o lo retira de la cola si aun esperaba) y admite los
+ * procesos en espera que quepan. Devuelve lo mismo que liberar_proceso();
+ * un proceso retirado de la cola devuelve PROCESO_EN_COLA
+ */
+int terminar_proceso(int id_proceso, int informar) {
+    int resultado;
+    
+    PERFIL_ENTRAR(PERFIL_CERRAR);
+    avanzar_reloj();
+    resultado = liberar_proceso(id_proceso);
+    if (resultado == -1) {
+        resultado = cancelar_pendiente(id_proceso) ? PROCESO_EN_COLA : -1;
+        return PERFIL_SALIR(PERFIL_CERRAR, resultado);
+    }
+    drenar_cola(informar);
+    return PERFIL_SALIR(PERFIL_CERRAR, resultado);
+}
+
+/**
+ * Solicita al usuario la politica de la cola de espera
+ */
+void seleccionar_cola(void) {
+    do {
+        printf("Cola de espera (0 = ninguna, 1 = FIFO, 2 = por tamano, 3 = por prioridad): ");
+        scanf("%d", &politica_cola);
+        if (politica_cola < COLA_DESACTIVADA || politica_cola > COLA_PRIORIDAD) {
+            printf("Error: Opcion invalida.\n");
+        }
+    } while (politica_cola < COLA_DESACTIVADA || politica_cola > COLA_PRIORIDAD);
+    
+    if (politica_cola != COLA_DESACTIVADA) {
+        do {
+            printf("Capacidad de la cola (0 = sin limite): ");
+            scanf("%d", &capacidad_cola);
+            if (capacidad_cola < 0) {
+                printf("Error: La capacidad no puede ser negativa.\n");
+            }
+        } while (capacidad_cola < 0);
+    }
+}
+
+/**
+ * Muestra los procesos en espera en orden de atencion
+ */
+void mostrar_cola(void) {
+    Pendiente **orden;
+    Pendiente *actual;
+    int i;
+    
+    printf("\n========== COLA DE ESPERA (%s) ==========\n", nombres_cola[politica_cola]);
+    printf("%-10s %-15s %-12s %-12s\n", "ID", "Tamano (KB)", "Prioridad", "Espera");
+    printf("--------------------------------------------------\n");
+    if (longitud_cola == 0) {
+        printf("No hay procesos en espera.\n");
+    } else if (politica_cola == COLA_PRIORIDAD) {
+        /* El monticulo solo garantiza la cima: se ordena una copia */
+        orden = (Pendiente **)malloc(longitud_cola * sizeof(Pendiente *));
+        if (orden == NULL) {
+            printf("Error: No se pudo asignar memoria para mostrar la cola.\n");
+        } else {
+            preparar_monticulo();
+            memcpy(orden, monticulo_cola, longitud_cola * sizeof(Pendiente *));
+            qsort(orden, (size_t)longitud_cola, sizeof(Pendiente *), comparar_pendientes);
+            for (i = 0; i < longitud_cola; i++) {
+                printf("%-10d %-15d %-12d %-12ld\n", orden[i]->id, orden[i]->tamano,
+                       orden[i]->prioridad, reloj_operaciones - orden[i]->llegada);
+            }
+            free(orden);
+        }
+    } else {
+        for (i = cabeza_cola; i < ranuras_usadas; i++) {
+            actual = cola_ranuras[i];
+            if (actual != NULL) {
+                printf("%-10d %-15d %-12d %-12ld\n", actual->id, actual->tamano,
+                       actual->prioridad, reloj_operaciones - actual->llegada);
+            }
+        }
+    }
+    mostrar_metricas_cola();
+    printf("=======================================\n");
+}
+
+/**
+ * Imprime las metricas de la cola (esperas en operaciones)
+ */
+void mostrar_metricas_cola(void) {
+    printf("Cola: %ld encolados, %ld atendidos, %ld rechazados, %ld cancelados, %d en espera\n",
+           cola_encolados, cola_atendidos, cola_rechazados, cola_cancelados, longitud_cola);
+    printf("Espera: media %.2f, maxima %ld operaciones\n",
+           cola_atendidos > 0 ? (double)cola_espera_total / cola_atendidos : 0.0,
+           cola_espera_maxima);
+    printf("Profundidad: media %.2f, maxima %d\n",
+           reloj_operaciones > 0 ? cola_profundidad_acumulada / reloj_operaciones : 0.0,
+           cola_profundidad_maxima);
+}
+
+/**
+ * Libera los procesos en espera y reinicia las metricas de la cola
+ */
+void vaciar_cola(void) {
+    BloquePendientes *bloque;
+    
+    while (bloques_pendientes != NULL) {
+        bloque = bloques_pendientes;
+        bloques_pendientes = bloque->siguiente;
+        free(bloque);
+    }
+    free(cola_ranuras);
+    free(arbol_cola);
+    free(monticulo_cola);
+    free(indice_cola);
+    cola_ranuras = NULL;
+    arbol_cola = NULL;
+    monticulo_cola = NULL;
+    indice_cola = NULL;
+    pendientes_libres = NULL;
+    hojas_cola = 0;
+    ranuras_usadas = 0;
+    cabeza_cola = 0;
+    capacidad_monticulo = 0;
+    monticulo_al_dia = 1;
+    cubetas_cola = 0;
+    longitud_cola = 0;
+    reloj_operaciones = 0;
+    cola_encolados = 0;
+    cola_atendidos = 0;
+    cola_rechazados = 0;
+    cola_cancelados = 0;
+    cola_espera_total = 0;
+    cola_espera_maxima = 0;
+    cola_profundidad_maxima = 0;
+    cola_profundidad_acumulada = 0.0;
+}
+
+/* ==================== INSTANTANEAS ==================== */
+
+/**
+ * Redondea un desplazamiento al siguiente multiplo de 8 bytes
+ */
+long alinear_instantanea(long desplazamiento) {
+    return (desplazamiento + 7L) & ~7L;
+}
+
+/**
+ * Escribe 'bytes' ceros (relleno de alineacion). Devuelve 0 si fallo
+ */
+int escribir_relleno(FILE *archivo, long bytes) {
+    static const char ceros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    
+    return bytes == 0 || fwrite(ceros, 1, (size_t)bytes, archivo) == (size_t)bytes;
+}
+
+/**
+ * Guarda el estado completo del esquema de particiones (tabla, procesos,
+ * historial de terminados, cola de espera, contadores y generador) en una
+ * instantanea binaria. Devuelve 1 si se escribio completa
+ */
+int guardar_instantanea(const char *ruta) {
+    CabeceraInstantanea cabecera;
+    RegistroProceso registro;
+    RegistroPendiente pendiente;
+    FILE *archivo;
+    Proceso *actual;
+    Pendiente *espera;
+    long columna;
+    long bits;
+    int correcto;
+    int i;
+    int j;
+    
+    if (esquema_memoria != ESQUEMA_PARTICIONES || num_particiones == 0) {
+        printf("Error: las instantaneas solo cubren particiones fijas o variables.\n");
+        return 0;
+    }
+    
+    memset(&cabecera, 0, sizeof(CabeceraInstantanea));
+    memcpy(cabecera.magia, MAGIA_INSTANTANEA, sizeof(MAGIA_INSTANTANEA));
+    cabecera.version = VERSION_INSTANTANEA;
+    cabecera.orden_bytes = ORDEN_BYTES_INSTANTANEA;
+    cabecera.bytes_long = (int)sizeof(long);
+    cabecera.bytes_cabecera = (int)sizeof(CabeceraInstantanea);
+    cabecera.num_particiones = num_particiones;
+    cabecera.tamano_total_memoria = tamano_total_memoria;
+    cabecera.tamano_particion = tamano_particion;
+    cabecera.particiones_variables = particiones_variables;
+    cabecera.politica = (int)(politica_actual - politicas);
+    cabecera.ultima_asignada = ultima_asignada;
+    cabecera.contador_procesos = contador_procesos;
+    cabecera.num_procesos = procesos_en_indice;
+    cabecera.politica_cola = politica_cola;
+    cabecera.capacidad_cola = capacidad_cola;
+    cabecera.longitud_cola = longitud_cola;
+    cabecera.cola_profundidad_maxima = cola_profundidad_maxima;
+    cabecera.estado_aleatorio = estado_aleatorio;
+    cabecera.reloj_operaciones = reloj_operaciones;
+    cabecera.num_terminados = num_terminados;
+    cabecera.cola_encolados = cola_encolados;
+    cabecera.cola_atendidos = cola_atendidos;
+    cabecera.cola_rechazados = cola_rechazados;
+    cabecera.cola_cancelados = cola_cancelados;
+    cabecera.cola_espera_total = cola_espera_total;
+    cabecera.cola_espera_maxima = cola_espera_maxima;
+    cabecera.cola_profundidad_acumulada = cola_profundidad_acumulada;
+    cabecera.estadisticas = estadisticas;
+    
+    /* Desplazamientos de cada seccion */
+    columna = (long)num_particiones * (long)sizeof(int);
+    bits = (long)((num_particiones + BITS_POR_PALABRA - 1) / BITS_POR_PALABRA) *
+           (long)sizeof(unsigned long);
+    cabecera.desp_direcciones = alinear_instantanea((long)sizeof(CabeceraInstantanea));
+    cabecera.desp_tamanos = alinear_instantanea(cabecera.desp_direcciones + columna);
+    cabecera.desp_ids = alinear_instantanea(cabecera.desp_tamanos + columna);
+    cabecera.desp_usados = alinear_instantanea(cabecera.desp_ids + columna);
+    cabecera.desp_ocupadas = alinear_instantanea(cabecera.desp_usados + columna);
+    cabecera.desp_procesos = alinear_instantanea(cabecera.desp_ocupadas + bits);
+    cabecera.desp_terminados = alinear_instantanea(cabecera.desp_procesos +
+        (long)procesos_en_indice * (long)sizeof(RegistroProceso));
+    cabecera.desp_pendientes = alinear_instantanea(cabecera.desp_terminados +
+        num_terminados * (long)sizeof(Terminado));
+    cabecera.tamano_archivo = alinear_instantanea(cabecera.desp_pendientes +
+        (long)longitud_cola * (long)sizeof(RegistroPendiente));
+    
+    archivo = fopen(ruta, "wb");
+    if (archivo == NULL) {
+        printf("Error: No se pudo crear la instantanea '%s'.\n", ruta);
+        return 0;
+    }
+    
+    /* Cada seccion se completa con ceros hasta el desplazamiento siguiente */
+    correcto = fwrite(&cabecera, sizeof(CabeceraInstantanea), 1, archivo) == 1 &&
+        escribir_relleno(archivo, cabecera.desp_direcciones - (long)sizeof(CabeceraInstantanea)) &&
+        fwrite(tabla_particiones.direccion_inicio, sizeof(int), num_particiones, archivo) ==
+            (size_t)num_particiones &&
+        escribir_relleno(archivo, cabecera.desp_tamanos - cabecera.desp_direcciones - columna) &&
+        fwrite(tabla_particiones.tamano, sizeof(int), num_particiones, archivo) ==
+            (size_t)num_particiones &&
+        escribir_relleno(archivo, cabecera.desp_ids - cabecera.desp_tamanos - columna) &&
+        fwrite(tabla_particiones.id_proceso, sizeof(int), num_particiones, archivo) ==
+            (size_t)num_particiones &&
+        escribir_relleno(archivo, cabecera.desp_usados - cabecera.desp_ids - columna) &&
+        fwrite(tabla_particiones.tamano_usado, sizeof(int), num_particiones, archivo) ==
+            (size_t)num_particiones &&
+        escribir_relleno(archivo, cabecera.desp_ocupadas - cabecera.desp_usados - columna) &&
+        fwrite(tabla_particiones.ocupadas, 1, (size_t)bits, archivo) == (size_t)bits &&
+        escribir_relleno(archivo, cabecera.desp_procesos - cabecera.desp_ocupadas - bits);
+    
+    /* Procesos en orden de creacion, para reconstruir la lista igual */
+    for (actual = lista_procesos; correcto && actual != NULL; actual = actual->siguiente) {
+        registro.id = actual->id;
+        registro.tamano = actual->tamano_requerido;
+        registro.direccion = actual->direccion_asignada;
+        registro.particion = actual->particion;
+        correcto = fwrite(&registro, sizeof(RegistroProceso), 1, archivo) == 1;
+    }
+    correcto = correcto &&
+        escribir_relleno(archivo, cabecera.desp_terminados - cabecera.desp_procesos -
+                                  (long)procesos_en_indice * (long)sizeof(RegistroProceso)) &&
+        (num_terminados == 0 ||
+         fwrite(terminados, sizeof(Terminado), (size_t)num_terminados, archivo) ==
+             (size_t)num_terminados) &&
+        escribir_relleno(archivo, cabecera.desp_pendientes - cabecera.desp_terminados -
+                                  num_terminados * (long)sizeof(Terminado));
+    
+    i = 0;
+    for (j = cabeza_cola; correcto && j < ranuras_usadas; j++) {
+        espera = cola_ranuras[j];
+        if (espera == NULL) {
+            continue;
+        }
+        pendiente.id = espera->id;
+        pendiente.tamano = espera->tamano;
+        pendiente.prioridad = espera->prioridad;
+        pendiente.llegada = espera->llegada;
+        correcto = fwrite(&pendiente, sizeof(RegistroPendiente), 1, archivo) == 1;
+        i++;
+    }
+    correcto = correcto &&
+        escribir_relleno(archivo, cabecera.tamano_archivo - cabecera.desp_pendientes -
+                                  (long)i * (long)sizeof(RegistroPendiente));
+    
+    if (fclose(archivo) != 0) {
+        correcto = 0;
+    }
+    if (!correcto) {
+        printf("Error: No se pudo escribir la instantanea '%s'.\n", ruta);
+    }
+    return correcto;
+}
+
+/**
+ * Revisa, sobre las columnas dentro del archivo, que cada particion quepa
+ * en la memoria y que cada proceso coincida con su particion ocupada
+ * (direccion, ID y tamano). Devuelve 1 si el contenido es coherente
+ */
+int validar_contenido_instantanea(const char *datos) {
+    const CabeceraInstantanea *cabecera;
+    const RegistroProceso *registros;
+    const int *direcciones;
+    const int *tamanos;
+    const int *ids;
+    const unsigned long *ocupadas;
+    int particion;
+    int i;
+    
+    cabecera = (const CabeceraInstantanea *)datos;
+    direcciones = (const int *)(datos + cabecera->desp_direcciones);
+    tamanos = (const int *)(datos + cabecera->desp_tamanos);
+    ids = (const int *)(datos + cabecera->desp_ids);
+    ocupadas = (const unsigned long *)(datos + cabecera->desp_ocupadas);
+    registros = (const RegistroProceso *)(datos + cabecera->desp_procesos);
+    
+    if (cabecera->tamano_total_memoria <= 0) {
+        return 0;
+    }
+    for (i = 0; i < cabecera->num_particiones; i++) {
+        if (direcciones[i] < 0 || tamanos[i] < 1 ||
+            tamanos[i] > cabecera->tamano_total_memoria - direcciones[i]) {
+            return 0;
+        }
+    }
+    for (i = 0; i < cabecera->num_procesos; i++) {
+        particion = registros[i].particion;
+        if (particion < 0 || particion >= cabecera->num_particiones ||
+            !((ocupadas[particion / BITS_POR_PALABRA] >> (particion % BITS_POR_PALABRA)) & 1UL) ||
+            registros[i].direccion != direcciones[particion] ||
+            registros[i].tamano < 1 || registros[i].tamano > tamanos[particion] ||
+            registros[i].id != ids[particion]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Restaura el estado guardado por guardar_instantanea(). El archivo se
+ * mapea en memoria (o se lee entero si no hay mmap) y las columnas de la
+ * tabla y el historial de terminados se usan en su lugar, sin copiarlos;
+ * el mapeo es privado, asi que modificarlos no altera el archivo. Solo se
+ * reconstruyen los indices: procesos, libres y cola. Devuelve 1 si cargo
+ */
+int cargar_instantanea(const char *ruta) {
+    const CabeceraInstantanea *cabecera;
+    const RegistroProceso *registros;
+    const RegistroPendiente *pendientes;
+    Proceso *nodo;
+    char *datos;
+    size_t tamano;
+    long columna;
+    long bits;
+    int palabras;
+    int valida;
+    int danada;
+    int i;
+    int w;
+#if defined(MAPEO_DISPONIBLE)
+    struct stat info;
+    int descriptor;
+#else
+    FILE *archivo;
+    long largo;
+#endif
+    
+    /* Obtener los bytes del archivo */
+    datos = NULL;
+    tamano = 0;
+#if defined(MAPEO_DISPONIBLE)
+    descriptor = open(ruta, O_RDONLY);
+    if (descriptor >= 0 && fstat(descriptor, &info) == 0 && info.st_size > 0) {
+        tamano = (size_t)info.st_size;
+        datos = (char *)mmap(NULL, tamano, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+        if (datos == (char *)MAP_FAILED) {
+            datos = NULL;
+        }
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+#else
+    archivo = fopen(ruta, "rb");
+    if (archivo != NULL && fseek(archivo, 0, SEEK_END) == 0 && (largo = ftell(archivo)) > 0) {
+        tamano = (size_t)largo;
+        datos = (char *)malloc(tamano);
+        rewind(archivo);
+        if (datos != NULL && fread(datos, 1, tamano, archivo) != tamano) {
+            free(datos);
+            datos = NULL;
+        }
+    }
+    if (archivo != NULL) {
+        fclose(archivo);
+    }
+#endif
+    if (datos == NULL) {
+        printf("Error: No se pudo leer la instantanea '%s'.\n", ruta);
+        return 0;
+    }
+    
+    /* Validar la cabecera y que cada seccion quepa en el archivo */
+    cabecera = (const CabeceraInstantanea *)datos;
+    valida = tamano >= sizeof(CabeceraInstantanea) &&
+             memcmp(cabecera->magia, MAGIA_INSTANTANEA, sizeof(MAGIA_INSTANTANEA)) == 0 &&
+             cabecera->version == VERSION_INSTANTANEA &&
+             cabecera->orden_bytes == ORDEN_BYTES_INSTANTANEA &&
+             cabecera->bytes_long == (int)sizeof(long) &&
+             cabecera->bytes_cabecera == (int)sizeof(CabeceraInstantanea) &&
+             cabecera->tamano_archivo == (long)tamano;
+    if (valida) {
+        columna = (long)cabecera->num_particiones * (long)sizeof(int);
+        palabras = (cabecera->num_particiones + BITS_POR_PALABRA - 1) / BITS_POR_PALABRA;
+        bits = (long)palabras * (long)sizeof(unsigned long);
+        valida = cabecera->num_particiones > 0 &&
+                 cabecera->politica >= 0 && cabecera->politica < NUM_POLITICAS &&
+                 cabecera->politica_cola >= COLA_DESACTIVADA &&
+                 cabecera->politica_cola <= COLA_PRIORIDAD &&
+                 cabecera->num_procesos >= 0 && cabecera->num_procesos <= cabecera->num_particiones &&
+                 cabecera->num_terminados >= 0 && cabecera->longitud_cola >= 0 &&
+                 cabecera->desp_direcciones >= (long)sizeof(CabeceraInstantanea) &&
+                 cabecera->desp_tamanos >= cabecera->desp_direcciones + columna &&
+                 cabecera->desp_ids >= cabecera->desp_tamanos + columna &&
+                 cabecera->desp_usados >= cabecera->desp_ids + columna &&
+                 cabecera->desp_ocupadas >= cabecera->desp_usados + columna &&
+                 cabecera->desp_procesos >= cabecera->desp_ocupadas + bits &&
+                 cabecera->desp_terminados >= cabecera->desp_procesos +
+                     (long)cabecera->num_procesos * (long)sizeof(RegistroProceso) &&
+                 cabecera->desp_pendientes >= cabecera->desp_terminados +
+                     cabecera->num_terminados * (long)sizeof(Terminado) &&
+                 cabecera->tamano_archivo >= cabecera->desp_pendientes +
+                     (long)cabecera->longitud_cola * (long)sizeof(RegistroPendiente) &&
+                 cabecera->desp_direcciones % 8 == 0 && cabecera->desp_tamanos % 8 == 0 &&
+                 cabecera->desp_ids % 8 == 0 && cabecera->desp_usados % 8 == 0 &&
+                 cabecera->desp_ocupadas % 8 == 0 && cabecera->desp_procesos % 8 == 0 &&
+                 cabecera->desp_terminados % 8 == 0 && cabecera->desp_pendientes % 8 == 0;
+    }
+    danada = valida && !validar_contenido_instantanea(datos);
+    if (!valida || danada) {
+        if (danada) {
+            printf("Error: la instantanea '%s' esta danada.\n", ruta);
+        } else {
+            printf("Error: '%s' no es una instantanea valida para este programa.\n", ruta);
+        }
+#if defined(MAPEO_DISPONIBLE)
+        munmap(datos, tamano);
+#else
+        free(datos);
+#endif
+        return 0;
+    }
+    
+    /* Reemplazar el estado actual por el de la instantanea */
+    destruir_estado();
+    instantanea = datos;
+    tamano_instantanea = tamano;
+    tamano_total_memoria = cabecera->tamano_total_memoria;
+    tamano_particion = cabecera->tamano_particion;
+    num_particiones = cabecera->num_particiones;
+    particiones_variables = cabecera->particiones_variables;
+    politica_actual = &politicas[cabecera->politica];
+    esquema_memoria = ESQUEMA_PARTICIONES;
+    reservar_vector_memoria();
+    
+    /* Las columnas se usan dentro del archivo; solo 'proceso' es propia */
+    tabla_particiones.direccion_inicio = (int *)(datos + cabecera->desp_direcciones);
+    tabla_particiones.tamano = (int *)(datos + cabecera->desp_tamanos);
+    tabla_particiones.id_proceso = (int *)(datos + cabecera->desp_ids);
+    tabla_particiones.tamano_usado = (int *)(datos + cabecera->desp_usados);
+    tabla_particiones.ocupadas = (unsigned long *)(datos + cabecera->desp_ocupadas);
+    tabla_particiones.proceso = (Proceso **)calloc(num_particiones, sizeof(Proceso *));
+    tabla_en_instantanea = 1;
+    if (tabla_particiones.proceso == NULL || !pool_crecer(num_particiones) ||
+        !mapa_crear(&mapa_libres, num_particiones) ||
+        (particiones_variables && !construir_indices_variables())) {
+        printf("Error: No se pudo asignar memoria para restaurar la instantanea.\n");
+        destruir_estado();
+        return 0;
+    }
+    
+    /* Indices de libres: solo se visitan las palabras con ocupadas */
+    for (w = 0; w < palabras; w++) {
+        if (tabla_particiones.ocupadas[w] != 0) {
+            for (i = w * BITS_POR_PALABRA;
+                 i < num_particiones && i < (w + 1) * BITS_POR_PALABRA; i++) {
+                if (estado_particion(i)) {
+                    ocupar_particion(i);
+                }
+            }
+        }
+    }
+    
+    /* Procesos en su orden de creacion (ya validados salvo IDs repetidos) */
+    registros = (const RegistroProceso *)(datos + cabecera->desp_procesos);
+    for (i = 0; i < cabecera->num_procesos; i++) {
+        if (buscar_proceso(registros[i].id) != NULL) {
+            printf("Error: la instantanea '%s' esta danada.\n", ruta);
+            destruir_estado();
+            return 0;
+        }
+        nodo = agregar_proceso(registros[i].id, registros[i].tamano, registros[i].direccion,
+                               registros[i].particion);
+        if (nodo == NULL) {
+            destruir_estado();
+            return 0;
+        }
+        tabla_particiones.proceso[registros[i].particion] = nodo;
+        if (memoria != NULL) {
+            llenar_celdas(memoria + registros[i].direccion, registros[i].tamano, registros[i].id);
+        }
+    }
+    
+    /* Historial en su lugar; se copia si vuelve a crecer */
+    terminados = (Terminado *)(datos + cabecera->desp_terminados);
+    num_terminados = cabecera->num_terminados;
+    capacidad_terminados = num_terminados;
+    terminados_en_instantanea = 1;
+    
+    /* Cola de espera: se vuelve a encolar en orden de llegada */
+    politica_cola = cabecera->politica_cola;
+    capacidad_cola = 0;
+    pendientes = (const RegistroPendiente *)(datos + cabecera->desp_pendientes);
+    for (i = 0; i < cabecera->longitud_cola; i++) {
+        if (!encolar_proceso(pendientes[i].id, pendientes[i].tamano, pendientes[i].prioridad)) {
+            printf("Error: No se pudo asignar memoria para la cola de espera.\n");
+            destruir_estado();
+            return 0;
+        }
+        buscar_pendiente(pendientes[i].id)->llegada = pendientes[i].llegada;
+    }
+    
+    /* Contadores y generador */
+    capacidad_cola = cabecera->capacidad_cola;
+    ultima_asignada = cabecera->ultima_asignada;
+    contador_procesos = cabecera->contador_procesos;
+    estado_aleatorio = cabecera->estado_aleatorio;
+    reloj_operaciones = cabecera->reloj_operaciones;
+    cola_encolados = cabecera->cola_encolados;
+    cola_atendidos = cabecera->cola_atendidos;
+    cola_rechazados = cabecera->cola_rechazados;
+    cola_cancelados = cabecera->cola_cancelados;
+    cola_espera_total = cabecera->cola_espera_total;
+    cola_espera_maxima = cabecera->cola_espera_maxima;
+    cola_profundidad_maxima = cabecera->cola_profundidad_maxima;
+    cola_profundidad_acumulada = cabecera->cola_profundidad_acumulada;
+    estadisticas = cabecera->estadisticas;
+    return 1;
+}
+
+/**
+ * Libera la instantanea cargada (desmapea o libera el bufer leido)
+ */
+void liberar_instantanea(void) {
+    if (instantanea != NULL) {
+#if defined(MAPEO_DISPONIBLE)
+        munmap(instantanea, tamano_instantanea);
+#else
+        free(instantanea);
+#endif
+    }
+    instantanea = NULL;
+    tamano_instantanea = 0;
+}
+
+/**
+ * Pide una ruta al usuario y guarda en ella el estado actual
+ */
+void guardar_estado(void) {
+    char ruta[256];
+    
+    printf("\n--- GUARDAR ESTADO ---\n");
+    printf("Archivo de la instantanea: ");
+    if (scanf("%255s", ruta) != 1) {
+        return;
+    }
+    if (guardar_instantanea(ruta)) {
+        printf(">>> Estado guardado en '%s' (%d procesos, %ld terminados).\n",
+               ruta, procesos_en_indice, num_terminados);
+    }
+}
+
+/* ==================== EXPORTACION DE METRICAS ==================== */
+
+/**
+ * Devuelve la tabla de exportacion con ese nombre o -1 si no existe
+ */
+int buscar_exportacion(const char *nombre) {
+    int i;
+    
+    for (i = 0; i < NUM_EXPORTACIONES; i++) {
+        if (strcmp(nombre, nombres_exportacion[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * KB reservados para un proceso con el motor activo (su particion, bloque
+ * o paginas enteras)
+ */
+long kb_asignados_proceso(const Proceso *proceso) {
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        return proceso->tamano_requerido;
+    }
+    if (esquema_memoria == ESQUEMA_BUDDY) {
+        return 1L << proceso->particion;
+    }
+    if (esquema_memoria == ESQUEMA_PAGINACION) {
+        return (long)proceso->particion * tamano_pagina;
+    }
+    return tabla_particiones.tamano[proceso->particion];
+}
+
+/**
+ * Abre una tabla: en JSON un arreglo de objetos (o un objeto si 'objeto')
+ * dentro del documento; en CSV la linea de cabecera
+ */
+void exportar_inicio_tabla(const char *nombre, const char *cabecera, int objeto) {
+    filas_exportadas = 0;
+    tabla_es_objeto = objeto;
+    if (formato_exportacion == FORMATO_CSV) {
+        salida_cadena(cabecera);
+        salida_texto("\n", 1);
+        return;
+    }
+    salida_cadena(tablas_exportadas > 0 ? ",\n  \"" : "  \"");
+    salida_cadena(nombre);
+    salida_cadena(objeto ? "\": " : "\": [");
+    tablas_exportadas++;
+}
+
+/**
+ * Cierra la tabla en curso
+ */
+void exportar_fin_tabla(void) {
+    if (formato_exportacion == FORMATO_JSON && !tabla_es_objeto) {
+        salida_cadena(filas_exportadas > 0 ? "\n  ]" : "]");
+    }
+}
+
+/**
+ * Abre una fila de la tabla en curso
+ */
+void exportar_inicio_fila(void) {
+    campos_exportados = 0;
+    if (formato_exportacion == FORMATO_JSON) {
+        if (!tabla_es_objeto) {
+            salida_cadena(filas_exportadas > 0 ? ",\n    " : "\n    ");
+        }
+        salida_texto("{", 1);
+    }
+}
+
+/**
+ * Cierra la fila en curso
+ */
+void exportar_fin_fila(void) {
+    salida_texto(formato_exportacion == FORMATO_JSON ? "}" : "\n", 1);
+    filas_exportadas++;
+}
+
+/**
+ * Separa el campo del anterior y, en JSON, escribe su nombre
+ */
+void exportar_nombre(const char *nombre) {
+    if (formato_exportacion == FORMATO_CSV) {
+        if (campos_exportados > 0) {
+            salida_texto(",", 1);
+        }
+    } else {
+        salida_cadena(campos_exportados > 0 ? ", \"" : "\"");
+        salida_cadena(nombre);
+        salida_texto("\": ", 3);
+    }
+    campos_exportados++;
+}
+
+/**
+ * Agrega un campo entero a la fila en curso
+ */
+void exportar_entero(const char *nombre, long valor) {
+    exportar_nombre(nombre);
+    salida_entero(valor, 0);
+}
+
+/**
+ * Agrega un campo con dos decimales a la fila en curso
+ */
+void exportar_decimal(const char *nombre, double valor) {
+    exportar_nombre(nombre);
+    salida_decimal(valor);
+}
+
+/**
+ * Agrega un campo de texto a la fila en curso. Los valores son nombres
+ * fijos del programa, asi que no necesitan escaparse
+ */
+void exportar_cadena(const char *nombre, const char *valor) {
+    exportar_nombre(nombre);
+    if (formato_exportacion == FORMATO_JSON) {
+        salida_texto("\"", 1);
+        salida_cadena(valor);
+        salida_texto("\"", 1);
+    } else {
+        salida_cadena(valor);
+    }
+}
+
+/**
+ * Escribe la fila de una particion, bloque o marco (id_proceso -1 = libre)
+ */
+void exportar_fila_particion(long particion, long inicio, long tamano, int id_proceso,
+                             long usado) {
+    exportar_inicio_fila();
+    exportar_entero("particion", particion);
+    exportar_entero("inicio_kb", inicio);
+    exportar_entero("tamano_kb", tamano);
+    exportar_cadena("estado", id_proceso == -1 ? "libre" : "ocupada");
+    exportar_entero("id_proceso", id_proceso);
+    exportar_entero("usado_kb", usado);
+    exportar_decimal("fragmentacion", usado > 0 ?
+                     calcular_fragmentacion((int)tamano, (int)usado) : 0.0);
+    exportar_fin_fila();
+}
+
+/**
+ * Exporta los procesos en memoria en orden de creacion
+ */
+void exportar_procesos(void) {
+    Proceso *actual;
+    long asignado;
+    
+    exportar_inicio_tabla("procesos", "id,tamano_kb,direccion_kb,asignado_kb,fragmentacion", 0);
+    for (actual = lista_procesos; actual != NULL; actual = actual->siguiente) {
+        asignado = kb_asignados_proceso(actual);
+        exportar_inicio_fila();
+        exportar_entero("id", actual->id);
+        exportar_entero("tamano_kb", actual->tamano_requerido);
+        exportar_entero("direccion_kb", actual->direccion_asignada);
+        exportar_entero("asignado_kb", asignado);
+        exportar_decimal("fragmentacion",
+                         calcular_fragmentacion((int)asignado, actual->tamano_requerido));
+        exportar_fin_fila();
+    }
+    exportar_fin_tabla();
+}
+
+/**
+ * Exporta en orden de direccion las particiones, los bloques (dinamicos o
+ * buddy) o los marcos, segun el motor activo
+ */
+void exportar_particiones(void) {
+    Proceso **orden;
+    int i;
+    int k;
+    int siguiente;
+    long numero;
+    
+    exportar_inicio_tabla("particiones",
+                          "particion,inicio_kb,tamano_kb,estado,id_proceso,usado_kb,fragmentacion", 0);
+    if (esquema_memoria == ESQUEMA_DINAMICO) {
+        for (i = 0; i != -1; i = bloques[i].siguiente) {
+            exportar_fila_particion(i, bloques[i].inicio, bloques[i].tamano,
+                                    bloques[i].libre ? -1 : bloques[i].proceso->id,
+                                    bloques[i].libre ? 0 : bloques[i].tamano);
+        }
+    } else if (esquema_memoria == ESQUEMA_BUDDY) {
+        orden = procesos_por_direccion();
+        if (orden == NULL && procesos_en_indice > 0) {
+            printf("Error: No se pudo asignar memoria para la tabla.\n");
+            error_salida = 1;
+        } else {
+            siguiente = 0;
+            numero = 0;
+            for (i = 0; i < tamano_total_memoria; i += 1 << k) {
+                if (bloque_buddy_en(i, &k)) {
+                    exportar_fila_particion(numero++, i, 1L << k, -1, 0);
+                } else {
+                    exportar_fila_particion(numero++, i, 1L << k, orden[siguiente]->id,
+                                            orden[siguiente]->tamano_requerido);
+                    siguiente++;
+                }
+            }
+        }
+        if (orden != NULL) {
+            free(orden);
+        }
+    } else if (esquema_memoria == ESQUEMA_PAGINACION) {
+        for (i = 0; i < num_marcos; i++) {
+            exportar_fila_particion(i, (long)i * tamano_pagina, tamano_pagina,
+                                    marco_proceso[i], marco_usado[i]);
+        }
+    } else {
+        for (i = 0; i < num_particiones; i++) {
+            exportar_fila_particion(i, tabla_particiones.direccion_inicio[i],
+                                    tabla_particiones.tamano[i],
+                                    estado_particion(i) ? tabla_particiones.id_proceso[i] : -1,
+                                    tabla_particiones.tamano_usado[i]);
+        }
+    }
+    exportar_fin_tabla();
+}
+
+/**
+ * Exporta el historial de procesos terminados
+ */
+void exportar_terminados(void) {
+    long i;
+    
+    exportar_inicio_tabla("terminados", "id,tamano_kb,direccion_kb", 0);
+    for (i = 0; i < num_terminados; i++) {
+        exportar_inicio_fila();
+        exportar_entero("id", terminados[i].id);
+        exportar_entero("tamano_kb", terminados[i].tamano);
+        exportar_entero("direccion_kb", terminados[i].direccion);
+        exportar_fin_fila();
+    }
+    exportar_fin_tabla();
+}
+
+/**
+ * Exporta las estadisticas agregadas como una sola fila
+ */
+void exportar_estadisticas(void) {
+    exportar_inicio_tabla("estadisticas",
+                          "esquema,memoria_kb,procesos,kb_usados,kb_asignados,kb_desperdiciados,"
+                          "fragmentacion_interna,fragmentacion_promedio,fragmentacion_externa,"
+                          "admitidos,terminados,en_cola,compactaciones,kb_compactados", 1);
+    exportar_inicio_fila();
+    exportar_cadena("esquema", nombres_esquema[esquema_memoria]);
+    exportar_entero("memoria_kb", tamano_total_memoria);
+    exportar_entero("procesos", estadisticas.procesos);
+    exportar_entero("kb_usados", estadisticas.kb_usados);
+    exportar_entero("kb_asignados", estadisticas.kb_asignados);
+    exportar_entero("kb_desperdiciados", estadisticas.kb_asignados - estadisticas.kb_usados);
+    exportar_decimal("fragmentacion_interna", fragmentacion_interna_total());
+    exportar_decimal("fragmentacion_promedio", estadisticas.procesos > 0 ?
+                     estadisticas.suma_fragmentacion / estadisticas.procesos : 0.0);
+    exportar_decimal("fragmentacion_externa", fragmentacion_externa());
+    exportar_entero("admitidos", estadisticas.admitidos);
+    exportar_entero("terminados", num_terminados);
+    exportar_entero("en_cola", longitud_cola);
+    exportar_entero("compactaciones", compactaciones);
+    exportar_entero("kb_compactados", kb_compactados);
+    exportar_fin_fila();
+    exportar_fin_tabla();
+}
+
+/**
+ * Exporta el histograma de tamanos de los procesos admitidos (solo las
+ * clases no vacias)
+ */
+void exportar_histograma(void) {
+    int k;
+    
+    exportar_inicio_tabla("histograma", "desde_kb,hasta_kb,procesos,porcentaje", 0);
+    for (k = 0; k < NUM_CLASES; k++) {
+        if (estadisticas.histograma[k] > 0) {
+            exportar_inicio_fila();
+            exportar_entero("desde_kb", 1L << k);
+            exportar_entero("hasta_kb", (1L << (k + 1)) - 1);
+            exportar_entero("procesos", estadisticas.histograma[k]);
+            exportar_decimal("porcentaje",
+                             estadisticas.histograma[k] * 100.0 / estadisticas.admitidos);
+            exportar_fin_fila();
+        }
+    }
+    exportar_fin_tabla();
+}
+
+/**
+ * Escribe una tabla (o todas, solo en JSON) en 'ruta' ("-" = salida
+ * estandar). Las filas pasan por el bufer de salida a medida que se
+ * generan, asi que la memoria usada no depende del numero de filas.
+ * Devuelve 1 si se escribio todo y 0 si hubo un error
+ */
+int exportar_metricas(const char *ruta, int formato, int tabla) {
+    FILE *archivo;
+    
+    if (formato == FORMATO_CSV && tabla == EXPORTAR_TODAS) {
+        printf("Error: En CSV se exporta una tabla por archivo.\n");
+        return 0;
+    }
+    salida_vaciar();
+    if (strcmp(ruta, "-") == 0) {
+        archivo = stdout;
+    } else {
+        archivo = fopen(ruta, "w");
+        if (archivo == NULL) {
+            printf("Error: No se pudo crear '%s'.\n", ruta);
+            return 0;
+        }
+    }
+    archivo_salida = archivo;
+    error_salida = 0;
+    formato_exportacion = formato;
+    tablas_exportadas = 0;
+    
+    if (formato == FORMATO_JSON) {
+        salida_cadena("{\n");
+    }
+    if (tabla == EXPORTAR_TODAS || tabla == EXPORTAR_ESTADISTICAS) {
+        exportar_estadisticas();
+    }
+    if (tabla == EXPORTAR_TODAS || tabla == EXPORTAR_HISTOGRAMA) {
+        exportar_histograma();
+    }
+    if (tabla == EXPORTAR_TODAS || tabla == EXPORTAR_PROCESOS) {
+        exportar_procesos();
+    }
+    if (tabla == EXPORTAR_TODAS || tabla == EXPORTAR_PARTICIONES) {
+        exportar_particiones();
+    }
+    if (tabla == EXPORTAR_TODAS || tabla == EXPORTAR_TERMINADOS) {
+        exportar_terminados();
+    }
+    if (formato == FORMATO_JSON) {
+        salida_cadena("\n}\n");
+    }
+    
+    salida_vaciar();
+    archivo_salida = NULL;
+    if (archivo != stdout && fclose(archivo) != 0) {
+        error_salida = 1;
+    }
+    if (error_salida) {
+        printf("Error: No se pudo escribir '%s'.\n", ruta);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Solicita formato, tabla y archivo y exporta las metricas
+ */
+void exportar_interactivo(void) {
+    char ruta[256];
+    int formato;
+    int tabla;
+    
+    printf("\n--- EXPORTAR METRICAS ---\n");
+    do {
+        printf("Formato (1 = JSON, 2 = CSV): ");
+        scanf("%d", &formato);
+    } while (formato < 1 || formato > 2);
+    do {
+        printf("Tabla (0 = todas, 1 = procesos, 2 = particiones, 3 = terminados,\n");
+        printf("       4 = estadisticas, 5 = histograma): ");
+        scanf("%d", &tabla);
+        if (formato == 2 && tabla == EXPORTAR_TODAS) {
+            printf("Error: En CSV se exporta una tabla por archivo.\n");
+            tabla = -1;
+        }
+    } while (tabla < 0 || tabla >= NUM_EXPORTACIONES);
+    printf("Archivo (- = pantalla): ");
+    if (scanf("%255s", ruta) != 1) {
+        return;
+    }
+    if (exportar_metricas(ruta, formato == 1 ? FORMATO_JSON : FORMATO_CSV, tabla) &&
+        strcmp(ruta, "-") != 0) {
+        printf(">>> Se exporto '%s' en '%s'.\n", nombres_exportacion[tabla], ruta);
+    }
+}
+
+/* ==================== MODO POR LOTES ==================== */
+
+/**
+ * Ejecuta una traza de operaciones sin menu ni mensajes por operacion.
+ * Formato (una operacion por linea, '#' inicia un comentario):
+ *   M <memoria KB> <particion KB>   configura particiones iguales
+ *   V <cantidad> <tamano KB>        agrega particiones de ese tamano (modo
+ *                                   variable; varias lineas se concatenan)
+ *   D <memoria KB> [maximo KB]      particionamiento dinamico; el maximo es
+ *                                   el tope de A sin tamano (memoria / 10)
+ *   B <memoria KB> [maximo KB]      sistema de companeros (mismo maximo)
+ *   F <memoria KB> <pagina KB> [maximo KB]  paginacion
+ *   T <entradas> [vias]             TLB de la paginacion
+ *   W <politica>                    memoria virtual: fifo | lru | reloj | arc
+ *   P <politica>                    primer | mejor | peor | siguiente
+ *   Q <cola> [capacidad]            cola de espera: fifo | tamano | prioridad
+ *   S <semilla>                     semilla de los tamanos aleatorios (12345)
+ *   A [tamano KB] [prioridad]       crea un proceso (sin tamano o 0: aleatorio)
+ *   L <id>                          cierra el proceso con ese ID (o lo retira
+ *                                   de la cola si aun esperaba)
+ *   X <id> <direccion> [cantidad]   referencia 'cantidad' KB del proceso
+ *   C                               compacta la memoria
+ *   U <umbral>                      compacta al fallar una creacion si la
+ *                                   fragmentacion externa llega al umbral (%)
+ *   R <archivo>                     restaura una instantanea (configuracion)
+ *   G <archivo>                     guarda una instantanea del estado actual
+ *   E <json|csv> <archivo> [tabla]  exporta las metricas: todas (solo JSON),
+ *                                   procesos, particiones, terminados,
+ *                                   estadisticas o histograma
+ * La configuracion (M, D, B, F, R o lineas V) debe preceder a la primera
+ * A, L, C o E.
+ * Los IDs se asignan en orden a las creaciones exitosas (incluidas las que
+ * quedan en cola), empezando en 1. La semilla es fija, asi que una misma
+ * traza da siempre el mismo resultado.
+ * Si ruta es "-" se lee de la entrada estandar. Devuelve el codigo de salida
+ */
+int ejecutar_lote(const char *ruta) {
+    FILE *archivo;
+    char linea[256];
+    char *cursor;
+    char *fin;
+    char *palabras[3];
+    long numero_linea;
+    long valor;
+    long segundo;
+    long tercero;
+    long fisica;
+    long asignaciones_ok;
+    long asignaciones_fallidas;
+    long liberaciones_ok;
+    long liberaciones_fallidas;
+    long encoladas;
+    long operaciones;
+    int configurada;
+    int codigo;
+    int resultado;
+    int *tamanos;
+    int *ampliado;
+    int num_tamanos;
+    int capacidad_tamanos;
+    const PoliticaUbicacion *politica;
+    double umbral;
+    double inicio;
+    double segundos;
+    
+    if (strcmp(ruta, "-") == 0) {
+        archivo = stdin;
+    } else {
+        archivo = fopen(ruta, "r");
+        if (archivo == NULL) {
+            printf("Error: No se pudo abrir la traza '%s'.\n", ruta);
+            return 1;
+        }
+    }
+    
+    numero_linea = 0;
+    asignaciones_ok = 0;
+    asignaciones_fallidas = 0;
+    liberaciones_ok = 0;
+    liberaciones_fallidas = 0;
+    encoladas = 0;
+    configurada = 0;
+    codigo = 0;
+    tamanos = NULL;
+    num_tamanos = 0;
+    capacidad_tamanos = 0;
+    semilla_aleatoria(12345);
+    inicio = tiempo_ns();
+    
+    while (fgets(linea, sizeof(linea), archivo) != NULL) {
+        numero_linea++;
+        cursor = linea;
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+        if (*cursor == '#' || *cursor == '\n' || *cursor == '\r' || *cursor == '\0') {
+            continue;
+        }
+        
+        /* Las particiones variables se crean con la primera operacion */
+        if ((*cursor == 'A' || *cursor == 'L' || *cursor == 'C' || *cursor == 'E') &&
+            !configurada) {
+            if (num_tamanos == 0) {
+                printf("Error (linea %ld): falta la configuracion de memoria (M, D, B, F, R o V).\n",
+                       numero_linea);
+                codigo = 1;
+                break;
+            }
+            configurar_particiones_variables(num_tamanos, tamanos);
+            configurada = 1;
+        }
+        
+        switch (*cursor) {
+            case 'V':
+                valor = strtol(cursor + 1, &fin, 10);
+                segundo = strtol(fin, &fin, 10);
+                if (configurada || valor <= 0 || segundo <= 0 || segundo > INT_MAX ||
+                    valor > INT_MAX - num_tamanos) {
+                    printf("Error (linea %ld): particiones variables invalidas.\n",
+                           numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                while (num_tamanos + valor > capacidad_tamanos) {
+                    capacidad_tamanos = capacidad_tamanos == 0 ? 64 : capacidad_tamanos * 2;
+                    ampliado = (int *)realloc(tamanos, capacidad_tamanos * sizeof(int));
+                    if (ampliado == NULL) {
+                        printf("Error: No se pudo asignar memoria.\n");
+                        free(tamanos);
+                        exit(1);
+                    }
+                    tamanos = ampliado;
+                }
+                while (valor-- > 0) {
+                    tamanos[num_tamanos++] = (int)segundo;
+                }
+                break;
+            case 'P':
+                cursor++;
+                while (*cursor == ' ' || *cursor == '\t') {
+                    cursor++;
+                }
+                fin = cursor;
+                while (*fin != '\0' && *fin != ' ' && *fin != '\t' &&
+                       *fin != '\n' && *fin != '\r' && *fin != '#') {
+                    fin++;
+                }
+                *fin = '\0';
+                politica = buscar_politica(cursor);
+                if (politica == NULL) {
+                    printf("Error (linea %ld): politica desconocida '%s'.\n",
+                           numero_linea, cursor);
+                    codigo = 1;
+                    break;
+                }
+                politica_actual = politica;
+                break;
+            case 'R':
+            case 'G':
+                segundo = *cursor;
+                cursor++;
+                while (*cursor == ' ' || *cursor == '\t') {
+                    cursor++;
+                }
+                fin = cursor;
+                while (*fin != '\0' && *fin != ' ' && *fin != '\t' &&
+                       *fin != '\n' && *fin != '\r' && *fin != '#') {
+                    fin++;
+                }
+                *fin = '\0';
+                if (segundo == 'R') {
+                    if (configurada || num_tamanos > 0) {
+                        printf("Error (linea %ld): configuracion de memoria invalida.\n",
+                               numero_linea);
+                        codigo = 1;
+                    } else if (!cargar_instantanea(cursor)) {
+                        codigo = 1;
+                    } else {
+                        configurada = 1;
+                    }
+                } else if (!configurada || !guardar_instantanea(cursor)) {
+                    if (!configurada) {
+                        printf("Error (linea %ld): no hay estado que guardar.\n", numero_linea);
+                    }
+                    codigo = 1;
+                }
+                break;
+            case 'Q':
+                cursor++;
+                while (*cursor == ' ' || *cursor == '\t') {
+                    cursor++;
+                }
+                fin = cursor;
+                while (*fin != '\0' && *fin != ' ' && *fin != '\t' &&
+                       *fin != '\n' && *fin != '\r' && *fin != '#') {
+                    fin++;
+                }
+                valor = strtol(fin, NULL, 10);
+                *fin = '\0';
+                for (segundo = COLA_FIFO; segundo <= COLA_PRIORIDAD; segundo++) {
+                    if (strcmp(cursor, nombres_cola[segundo]) == 0) {
+                        break;
+                    }
+                }
+                if (segundo > COLA_PRIORIDAD || valor < 0 || valor > INT_MAX) {
+                    printf("Error (linea %ld): cola de espera invalida '%s'.\n",
+                           numero_linea, cursor);
+                    codigo = 1;
+                    break;
+                }
+                politica_cola = (int)segundo;
+                capacidad_cola = (int)valor;
+                break;
+            case 'M':
+                valor = strtol(cursor + 1, &fin, 10);
+                segundo = strtol(fin, &fin, 10);
+                if (configurada || num_tamanos > 0 || valor <= 0 || valor > INT_MAX ||
+                    segundo <= 0 || segundo > valor) {
+                    printf("Error (linea %ld): configuracion de memoria invalida.\n",
+                           numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                configurar_memoria((int)valor, (int)segundo);
+                configurada = 1;
+                break;
+            case 'D':
+            case 'B':
+                valor = strtol(cursor + 1, &fin, 10);
+                segundo = strtol(fin, &fin, 10);
+                if (segundo <= 0) {
+                    segundo = valor / 10 > 0 ? valor / 10 : 1;
+                }
+                if (configurada || num_tamanos > 0 ||
+                    valor <= 0 || valor > INT_MAX || segundo > valor) {
+                    printf("Error (linea %ld): configuracion de memoria invalida.\n",
+                           numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                if (*cursor == 'D') {
+                    configurar_dinamica((int)valor, (int)segundo);
+                } else {
+                    configurar_buddy((int)valor, (int)segundo);
+                }
+                configurada = 1;
+                break;
+            case 'F':
+                valor = strtol(cursor + 1, &fin, 10);
+                segundo = strtol(fin, &fin, 10);
+                tercero = strtol(fin, &fin, 10);
+                if (tercero <= 0) {
+                    tercero = valor / 10 > 0 ? valor / 10 : 1;
+                }
+                if (configurada || num_tamanos > 0 || valor <= 0 || valor > INT_MAX ||
+                    segundo <= 0 || segundo > valor || tercero > INT_MAX ||
+                    (tercero > valor && politica_reemplazo == REEMPLAZO_NINGUNO)) {
+                    printf("Error (linea %ld): configuracion de memoria invalida.\n",
+                           numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                configurar_paginacion((int)valor, (int)segundo, (int)tercero);
+                configurada = 1;
+                break;
+            case 'T':
+                valor = strtol(cursor + 1, &fin, 10);
+                segundo = strtol(fin, &fin, 10);
+                if (segundo <= 0) {
+                    segundo = valor;
+                }
+                if (valor <= 0 || valor > INT_MAX || !configurar_tlb((int)valor, (int)segundo)) {
+                    printf("Error (linea %ld): TLB invalido.\n", numero_linea);
+                    codigo = 1;
+                }
+                break;
+            case 'W':
+                cursor++;
+                while (*cursor == ' ' || *cursor == '\t') {
+                    cursor++;
+                }
+                fin = cursor;
+                while (*fin != '\0' && *fin != ' ' && *fin != '\t' &&
+                       *fin != '\n' && *fin != '\r' && *fin != '#') {
+                    fin++;
+                }
+                *fin = '\0';
+                resultado = buscar_reemplazo(cursor);
+                if (configurada || resultado == -1) {
+                    printf("Error (linea %ld): memoria virtual invalida '%s'.\n",
+                           numero_linea, cursor);
+                    codigo = 1;
+                    break;
+                }
+                politica_reemplazo = resultado;
+                break;
+            case 'X':
+                valor = strtol(cursor + 1, &fin, 10);
+                segundo = strtol(fin, &fin, 10);
+                tercero = strtol(fin, &fin, 10);
+                if (!configurada || esquema_memoria != ESQUEMA_PAGINACION) {
+                    printf("Error (linea %ld): las referencias requieren paginacion (F).\n",
+                           numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                /* X <id> <direccion> [cantidad]: recorre 'cantidad' KB seguidos */
+                if (tercero <= 0) {
+                    tercero = 1;
+                }
+                while (tercero-- > 0) {
+                    traducir_direccion((int)valor, segundo++, &fisica);
+                }
+                break;
+            case 'E':
+                /* E <formato> <archivo> [tabla]: las palabras que faltan quedan vacias */
+                cursor++;
+                for (segundo = 0; segundo < 3; segundo++) {
+                    while (*cursor == ' ' || *cursor == '\t') {
+                        cursor++;
+                    }
+                    palabras[segundo] = cursor;
+                    while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t' &&
+                           *cursor != '\n' && *cursor != '\r' && *cursor != '#') {
+                        cursor++;
+                    }
+                    if (*cursor == ' ' || *cursor == '\t') {
+                        *cursor++ = '\0';
+                    } else {
+                        *cursor = '\0';
+                    }
+                }
+                resultado = *palabras[2] == '\0' ? EXPORTAR_TODAS : buscar_exportacion(palabras[2]);
+                if (strcmp(palabras[0], "json") == 0) {
+                    valor = FORMATO_JSON;
+                } else if (strcmp(palabras[0], "csv") == 0) {
+                    valor = FORMATO_CSV;
+                } else {
+                    valor = -1;
+                }
+                if (valor == -1 || *palabras[1] == '\0' || resultado == -1) {
+                    printf("Error (linea %ld): exportacion invalida.\n", numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                if (!exportar_metricas(palabras[1], (int)valor, resultado)) {
+                    codigo = 1;
+                }
+                break;
+            case 'C':
+                if (compactar_memoria() < 0) {
+                    printf("Error (linea %ld): la compactacion requiere particiones o "
+                           "particionamiento dinamico.\n", numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                drenar_cola(0);
+                break;
+            case 'U':
+                umbral = strtod(cursor + 1, &fin);
+                if (umbral < 0.0 || umbral > 100.0) {
+                    printf("Error (linea %ld): umbral de compactacion invalido.\n",
+                           numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                umbral_compactacion = umbral;
+                break;
+            case 'S':
+                semilla_aleatoria(strtoul(cursor + 1, &fin, 10));
+                break;
+            case 'A':
+                valor = strtol(cursor + 1, &fin, 10);
+                segundo = strtol(fin, &fin, 10);
+                if (valor > INT_MAX) {
+                    printf("Error (linea %ld): tamano de proceso invalido.\n", numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                if (valor <= 0) {
+                    valor = aleatorio_entre(1, tamano_particion);
+                }
+                if (segundo < 1 || segundo > PRIORIDAD_MAXIMA) {
+                    segundo = 1;
+                }
+                resultado = solicitar_proceso((int)valor, (int)segundo);
+                if (resultado == PROCESO_EN_COLA) {
+                    encoladas++;
+                } else if (resultado >= 0) {
+                    asignaciones_ok++;
+                } else {
+                    asignaciones_fallidas++;
+                }
+                break;
+            case 'L':
+                valor = strtol(cursor + 1, &fin, 10);
+                if (valor > INT_MAX || valor < INT_MIN) {
+                    printf("Error (linea %ld): ID de proceso invalido.\n", numero_linea);
+                    codigo = 1;
+                    break;
+                }
+                if (terminar_proceso((int)valor, 0) != -1) {
+                    liberaciones_ok++;
+                } else {
+                    liberaciones_fallidas++;
+                }
+                break;
+            default:
+                printf("Error (linea %ld): operacion desconocida '%c'.\n",
+                       numero_linea, *cursor);
+                codigo = 1;
+        }
+        if (codigo != 0) {
+            break;
+        }
+    }
+    
+    segundos = (tiempo_ns() - inicio) / 1e9;
+    if (archivo != stdin) {
+        fclose(archivo);
+    }
+    
+    if (codigo == 0 && !configurada && num_tamanos > 0) {
+        configurar_particiones_variables(num_tamanos, tamanos);
+        configurada = 1;
+    }
+    if (tamanos != NULL) {
+        free(tamanos);
+    }
+    if (codigo == 0 && !configurada) {
+        printf("Error: la traza no contiene la configuracion de memoria (M, D, B, F, R o V).\n");
+        codigo = 1;
+    }
+    
+    if (configurada) {
+        operaciones = asignaciones_ok + asignaciones_fallidas + encoladas +
+                      liberaciones_ok + liberaciones_fallidas;
+        printf("=== RESUMEN DE EJECUCION POR LOTES ===\n");
+        if (esquema_memoria == ESQUEMA_DINAMICO) {
+            printf("Memoria: %d KB con particionamiento dinamico\n", tamano_total_memoria);
+            printf("Politica: Ajuste segregado por clases de tamano\n");
+        } else if (esquema_memoria == ESQUEMA_BUDDY) {
+            printf("Memoria: %d KB con sistema de companeros\n", tamano_total_memoria);
+            printf("Politica: Menor bloque de potencia de 2 suficiente\n");
+        } else if (esquema_memoria == ESQUEMA_PAGINACION) {
+            printf("Memoria: %d KB con paginacion\n", tamano_total_memoria);
+            printf("Politica: Marcos libres en pila, sin contiguidad\n");
+        } else {
+            if (particiones_variables) {
+                printf("Memoria: %d KB en %d particiones de hasta %d KB\n",
+                       tamano_total_memoria, num_particiones, tamano_particion);
+            } else {
+                printf("Memoria: %d KB en %d particiones de %d KB\n",
+                       tamano_total_memoria, num_particiones, tamano_particion);
+            }
+            printf("Politica: %s\n", politica_actual->descripcion);
+        }
+        printf("Operaciones: %ld\n", operaciones);
+        if (politica_cola != COLA_DESACTIVADA) {
+            printf("Asignaciones: %ld inmediatas, %ld a la cola, %ld rechazadas\n",
+                   asignaciones_ok, encoladas, asignaciones_fallidas);
+        } else {
+            printf("Asignaciones: %ld exitosas, %ld rechazadas\n",
+                   asignaciones_ok, asignaciones_fallidas);
+        }
+        printf("Liberaciones: %ld exitosas, %ld fallidas\n",
+               liberaciones_ok, liberaciones_fallidas);
+        printf("Procesos activos al final: %d\n", procesos_en_indice);
+        if (politica_cola != COLA_DESACTIVADA) {
+            printf("Cola de espera: %s", nombres_cola[politica_cola]);
+            if (capacidad_cola > 0) {
+                printf(" (capacidad %d)", capacidad_cola);
+            }
+            printf("\n");
+            mostrar_metricas_cola();
+        }
+        if (esquema_memoria == ESQUEMA_DINAMICO) {
+            printf("Huecos al final: %d\n", num_huecos);
+        }
+        mostrar_metricas_compactacion();
+        if (esquema_memoria == ESQUEMA_PAGINACION) {
+            mostrar_metricas_paginacion();
+        }
+        printf("Fragmentacion al final: interna %.2f%%, externa %.2f%%\n",
+               fragmentacion_interna_total(), fragmentacion_externa());
+        printf("Memoria al final: %ld KB usados, %ld KB desperdiciados\n",
+               estadisticas.kb_usados, estadisticas.kb_asignados - estadisticas.kb_usados);
+        printf("Tiempo: %.3f s", segundos);
+        if (segundos > 0.0) {
+            printf(" (%.0f ops/s)", operaciones / segundos);
+        }
+        printf("\n");
+#if defined(PERFILADO)
+        mostrar_perfil();
+#endif
+        destruir_estado();
+    }
+    return codigo;
+}
+
+/* ==================== SIMULACION DE EVENTOS DISCRETOS ==================== */
+
+/**
+ * Logaritmo natural de x > 0, sin depender de libm: se reduce x a
+ * m * 2^e con m en [1, 2) y ln(m) se obtiene de la serie de atanh
+ */
+double logaritmo_natural(double x) {
+    double t;
+    double t2;
+    double termino;
+    double suma;
+    int exponente;
+    int n;
+    
+    exponente = 0;
+    while (x >= 2.0) {
+        x /= 2.0;
+        exponente++;
+    }
+    while (x < 1.0) {
+        x *= 2.0;
+        exponente--;
+    }
+    
+    /* ln(x) = 2 * (t + t^3/3 + t^5/5 + ...), con t = (x - 1) / (x + 1) <= 1/3 */
+    t = (x - 1.0) / (x + 1.0);
+    t2 = t * t;
+    termino = t;
+    suma = 0.0;
+    for (n = 1; n < 40; n += 2) {
+        suma += termino / n;
+        termino *= t2;
+    }
+    return 2.0 * suma + exponente * 0.69314718055994530942;
+}
+
+/**
+ * Muestra de una distribucion exponencial de la media dada (por inversion)
+ */
+double muestra_exponencial(double media) {
+    double u;
+    
+    /* u en (0, 1]: nunca se toma el logaritmo de 0 */
+    u = ((double)siguiente_aleatorio() + 1.0) / 4294967296.0;
+    return -media * logaritmo_natural(u);
+}
+
+/**
+ * Inserta un evento en el monticulo. Devuelve 0 si no hubo memoria
+ */
+int evento_agregar(double tiempo, int tipo, int id_proceso) {
+    Evento *ampliado;
+    Evento nuevo;
+    int hijo;
+    int padre;
+    
+    if (num_eventos == capacidad_eventos) {
+        capacidad_eventos = capacidad_eventos == 0 ? 64 : capacidad_eventos * 2;
+        ampliado = (Evento *)realloc(eventos, capacidad_eventos * sizeof(Evento));
+        if (ampliado == NULL) {
+            return 0;
+        }
+        eventos = ampliado;
+    }
+    nuevo.tiempo = tiempo;
+    nuevo.tipo = tipo;
+    nuevo.id = id_proceso;
+    nuevo.secuencia = secuencia_eventos++;
+    
+    /* Subir el hueco hasta la posicion del nuevo evento */
+    hijo = num_eventos++;
+    while (hijo > 0) {
+        padre = (hijo - 1) / 2;
+        if (eventos[padre].tiempo < nuevo.tiempo ||
+            (eventos[padre].tiempo == nuevo.tiempo &&
+             (eventos[padre].tipo < nuevo.tipo ||
+              (eventos[padre].tipo == nuevo.tipo && eventos[padre].secuencia < nuevo.secuencia)))) {
+            break;
+        }
+        eventos[hijo] = eventos[padre];
+        hijo = padre;
+    }
+    eventos[hijo] = nuevo;
+    return 1;
+}
+
+/**
+ * Extrae el evento mas proximo (tiempo, luego tipo, luego secuencia).
+ * Requiere num_eventos > 0
+ */
+Evento evento_extraer(void) {
+    Evento primero;
+    Evento ultimo;
+    int padre;
+    int hijo;
+    
+    primero = eventos[0];
+    ultimo = eventos[--num_eventos];
+    
+    /* Bajar el hueco de la raiz hasta donde quepa el ultimo evento */
+    padre = 0;
+    hijo = 1;
+    while (hijo < num_eventos) {
+        if (hijo + 1 < num_eventos &&
+            (eventos[hijo + 1].tiempo < eventos[hijo].tiempo ||
+             (eventos[hijo + 1].tiempo == eventos[hijo].tiempo &&
+              (eventos[hijo + 1].tipo < eventos[hijo].tipo ||
+               (eventos[hijo + 1].tipo == eventos[hijo].tipo &&
+                eventos[hijo + 1].secuencia < eventos[hijo].secuencia))))) {
+            hijo++;
+        }
+        if (ultimo.tiempo < eventos[hijo].tiempo ||
+            (ultimo.tiempo == eventos[hijo].tiempo &&
+             (ultimo.tipo < eventos[hijo].tipo ||
+              (ultimo.tipo == eventos[hijo].tipo && ultimo.secuencia < eventos[hijo].secuencia)))) {
+            break;
+        }
+        eventos[padre] = eventos[hijo];
+        padre = hijo;
+        hijo = 2 * padre + 1;
+    }
+    if (num_eventos > 0) {
+        eventos[padre] = ultimo;
+    }
+    return primero;
+}
+
+/**
+ * Guarda la llegada y la duracion de un proceso. Devuelve 0 si no hubo memoria
+ */
+int sim_registrar(int id_proceso, double llegada, double duracion) {
+    double *ampliado;
+    int nueva_capacidad;
+    
+    if (id_proceso >= capacidad_sim) {
+        nueva_capacidad = capacidad_sim == 0 ? 1024 : capacidad_sim;
+        while (nueva_capacidad <= id_proceso) {
+            nueva_capacidad *= 2;
+        }
+        ampliado = (double *)realloc(llegada_sim, nueva_capacidad * sizeof(double));
+        if (ampliado == NULL) {
+            return 0;
+        }
+        llegada_sim = ampliado;
+        ampliado = (double *)realloc(duracion_sim, nueva_capacidad * sizeof(double));
+        if (ampliado == NULL) {
+            return 0;
+        }
+        duracion_sim = ampliado;
+        capacidad_sim = nueva_capacidad;
+    }
+    llegada_sim[id_proceso] = llegada;
+    duracion_sim[id_proceso] = duracion;
+    return 1;
+}
+
+/**
+ * Un proceso entro en memoria: se programa su salida y se registra su espera
+ */
+void sim_admitido(int id_proceso) {
+    double espera;
+    
+    espera = tiempo_virtual - llegada_sim[id_proceso];
+    sim_admitidos++;
+    sim_espera_total += espera;
+    if (espera > sim_espera_maxima) {
+        sim_espera_maxima = espera;
+    }
+    if (espera > 0.0) {
+        sim_admitidos_cola++;
+    }
+    sim_kb_en_uso += buscar_proceso(id_proceso)->tamano_requerido;
+    if (!evento_agregar(tiempo_virtual + duracion_sim[id_proceso], EVENTO_SALIDA, id_proceso)) {
+        printf("Error: No se pudo asignar memoria para los eventos.\n");
+        exit(1);
+    }
+}
+
+/**
+ * Lee la siguiente llegada de una traza: "<instante> <tamano KB> <duracion>"
+ * por linea ('#' inicia un comentario). Devuelve 0 al final del archivo
+ */
+int sim_leer_llegada(FILE *traza, double *tiempo, int *tamano, double *duracion) {
+    char linea[256];
+    char *cursor;
+    char *fin;
+    
+    while (fgets(linea, sizeof(linea), traza) != NULL) {
+        cursor = linea;
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+        if (*cursor == '#' || *cursor == '\n' || *cursor == '\r' || *cursor == '\0') {
+            continue;
+        }
+        *tiempo = strtod(cursor, &fin);
+        *tamano = (int)strtol(fin, &fin, 10);
+        *duracion = strtod(fin, &fin);
+        if (*tamano > 0 && *duracion >= 0.0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Simulacion de eventos discretos. Los procesos llegan segun un proceso de
+ * Poisson (o una traza), ocupan memoria durante una duracion exponencial y
+ * salen solos; un monticulo minimo ordena llegadas y salidas en tiempo
+ * virtual. Opciones 'clave=valor':
+ *   llegadas=poisson|traza  origen de las llegadas (poisson)
+ *   traza=RUTA      lineas "<instante> <tamano KB> <duracion>", crecientes
+ *   tasa=F          llegadas por unidad de tiempo (1.0)
+ *   vida=F          duracion media de un proceso (10.0)
+ *   horizonte=F     tiempo virtual simulado (100000.0)
+ *   memoria=N       memoria total en KB (1024)
+ *   particion=N     tamano de particion y maximo de un proceso en KB (64)
+ *   esquema=fijo|dinamico|buddy  motor de asignacion (fijo)
+ *   politica=P      primer | mejor | peor | siguiente (primer)
+ *   cola=C          ninguna | fifo | tamano | prioridad (fifo)
+ *   capacidad=N     maximo de procesos en espera, 0 = sin limite (0)
+ *   semilla=N       semilla del generador (12345)
+ */
+int ejecutar_simulacion(int argc, char *argv[]) {
+    const char *llegadas;
+    const char *ruta;
+    const char *esquema;
+    FILE *traza;
+    unsigned long semilla;
+    double tasa;
+    double vida;
+    double horizonte;
+    int total;
+    int particion;
+    int i;
+    int tamano;
+    int id;
+    int resultado;
+    double proxima;
+    double duracion;
+    double anterior;
+    double uso_acumulado;
+    double cola_acumulada;
+    double activos_acumulados;
+    double inicio;
+    double segundos;
+    long llegadas_totales;
+    long completados;
+    long rechazados;
+    long atendidos_antes;
+    long eventos_procesados;
+    Evento evento;
+    
+    llegadas = "poisson";
+    ruta = NULL;
+    esquema = "fijo";
+    semilla = 12345;
+    tasa = 1.0;
+    vida = 10.0;
+    horizonte = 100000.0;
+    total = 1024;
+    particion = 64;
+    politica_actual = &politicas[0];
+    politica_cola = COLA_FIFO;
+    capacidad_cola = 0;
+    
+    for (i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "llegadas=", 9) == 0) {
+            llegadas = argv[i] + 9;
+        } else if (strncmp(argv[i], "traza=", 6) == 0) {
+            ruta = argv[i] + 6;
+        } else if (strncmp(argv[i], "tasa=", 5) == 0) {
+            tasa = strtod(argv[i] + 5, NULL);
+        } else if (strncmp(argv[i], "vida=", 5) == 0) {
+            vida = strtod(argv[i] + 5, NULL);
+        } else if (strncmp(argv[i], "horizonte=", 10) == 0) {
+            horizonte = strtod(argv[i] + 10, NULL);
+        } else if (strncmp(argv[i], "memoria=", 8) == 0) {
+            total = (int)strtol(argv[i] + 8, NULL, 10);
+        } else if (strncmp(argv[i], "particion=", 10) == 0) {
+            particion = (int)strtol(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "esquema=", 8) == 0) {
+            esquema = argv[i] + 8;
+        } else if (strncmp(argv[i], "politica=", 9) == 0) {
+            politica_actual = buscar_politica(argv[i] + 9);
+            if (politica_actual == NULL) {
+                printf("Error: politica desconocida '%s'.\n", argv[i] + 9);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "cola=", 5) == 0) {
+            for (politica_cola = COLA_PRIORIDAD; politica_cola > COLA_DESACTIVADA;
+                 politica_cola--) {
+                if (strcmp(argv[i] + 5, nombres_cola[politica_cola]) == 0) {
+                    break;
+                }
+            }
+            if (politica_cola == COLA_DESACTIVADA &&
+                strcmp(argv[i] + 5, nombres_cola[COLA_DESACTIVADA]) != 0) {
+                printf("Error: cola desconocida '%s'.\n", argv[i] + 5);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "capacidad=", 10) == 0) {
+            capacidad_cola = (int)strtol(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "semilla=", 8) == 0) {
+            semilla = strtoul(argv[i] + 8, NULL, 10);
+        } else {
+            printf("Error: opcion desconocida '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (tasa <= 0.0 || vida <= 0.0 || horizonte <= 0.0 || total <= 0 ||
+        particion <= 0 || particion > total || capacidad_cola < 0) {
+        printf("Error: parametros de la simulacion invalidos.\n");
+        return 1;
+    }
+    if (strcmp(llegadas, "poisson") != 0 && strcmp(llegadas, "traza") != 0) {
+        printf("Error: llegadas desconocidas '%s'.\n", llegadas);
+        return 1;
+    }
+    
+    traza = NULL;
+    if (strcmp(llegadas, "traza") == 0) {
+        if (ruta == NULL) {
+            printf("Error: llegadas=traza requiere traza=RUTA.\n");
+            return 1;
+        }
+        traza = strcmp(ruta, "-") == 0 ? stdin : fopen(ruta, "r");
+        if (traza == NULL) {
+            printf("Error: No se pudo abrir la traza '%s'.\n", ruta);
+            return 1;
+        }
+    }
+    
+    if (strcmp(esquema, "fijo") == 0) {
+        configurar_memoria(total, particion);
+    } else if (strcmp(esquema, "dinamico") == 0) {
+        configurar_dinamica(total, particion);
+    } else if (strcmp(esquema, "buddy") == 0) {
+        configurar_buddy(total, particion);
+    } else {
+        printf("Error: esquema desconocido '%s'.\n", esquema);
+        if (traza != NULL && traza != stdin) {
+            fclose(traza);
+        }
+        return 1;
+    }
+    semilla_aleatoria(semilla);
+    al_admitir_desde_cola = sim_admitido;
+    
+    tiempo_virtual = 0.0;
+    anterior = 0.0;
+    uso_acumulado = 0.0;
+    cola_acumulada = 0.0;
+    activos_acumulados = 0.0;
+    llegadas_totales = 0;
+    completados = 0;
+    rechazados = 0;
+    eventos_procesados = 0;
+    sim_kb_en_uso = 0.0;
+    sim_espera_total = 0.0;
+    sim_espera_maxima = 0.0;
+    sim_admitidos = 0;
+    sim_admitidos_cola = 0;
+    
+    /* Solo hay una llegada pendiente a la vez: se genera la siguiente al
+     * procesar cada una, asi el monticulo no crece con el horizonte */
+    tamano = 0;
+    duracion = 0.0;
+    if (traza != NULL) {
+        if (sim_leer_llegada(traza, &proxima, &tamano, &duracion)) {
+            evento_agregar(proxima, EVENTO_LLEGADA, 0);
+        }
+    } else {
+        evento_agregar(muestra_exponencial(1.0 / tasa), EVENTO_LLEGADA, 0);
+    }
+    
+    inicio = tiempo_ns();
+    while (num_eventos > 0 && eventos[0].tiempo <= horizonte) {
+        evento = evento_extraer();
+        eventos_procesados++;
+        
+        /* Integrar las metricas sobre el intervalo transcurrido */
+        uso_acumulado += sim_kb_en_uso * (evento.tiempo - anterior);
+        cola_acumulada += (double)longitud_cola * (evento.tiempo - anterior);
+        activos_acumulados += (double)procesos_en_indice * (evento.tiempo - anterior);
+        anterior = evento.tiempo;
+        tiempo_virtual = evento.tiempo;
+        
+        if (evento.tipo == EVENTO_SALIDA) {
+            sim_kb_en_uso -= buscar_proceso(evento.id)->tamano_requerido;
+            completados++;
+            terminar_proceso(evento.id, 0);
+            continue;
+        }
+        
+        /* Llegada: tamano y duracion de la traza o muestreados */
+        llegadas_totales++;
+        if (traza == NULL) {
+            tamano = aleatorio_entre(1, particion);
+            duracion = muestra_exponencial(vida);
+        }
+        id = contador_procesos;
+        if (!sim_registrar(id, tiempo_virtual, duracion)) {
+            printf("Error: No se pudo asignar memoria para la simulacion.\n");
+            exit(1);
+        }
+        /* Si entra sin pasar por drenar_cola() hay que programar su salida */
+        atendidos_antes = cola_atendidos;
+        resultado = solicitar_proceso(tamano, aleatorio_entre(1, PRIORIDAD_MAXIMA));
+        if (resultado >= 0 && cola_atendidos == atendidos_antes) {
+            sim_admitido(id);
+        } else if (resultado < 0 && resultado != PROCESO_EN_COLA) {
+            rechazados++;
+        }
+        
+        if (traza != NULL) {
+            if (sim_leer_llegada(traza, &proxima, &tamano, &duracion)) {
+                evento_agregar(proxima < tiempo_virtual ? tiempo_virtual : proxima,
+                               EVENTO_LLEGADA, 0);
+            }
+        } else {
+            evento_agregar(tiempo_virtual + muestra_exponencial(1.0 / tasa), EVENTO_LLEGADA, 0);
+        }
+    }
+    segundos = (tiempo_ns() - inicio) / 1e9;
+    
+    /* Cerrar el intervalo final hasta el horizonte */
+    uso_acumulado += sim_kb_en_uso * (horizonte - anterior);
+    cola_acumulada += (double)longitud_cola * (horizonte - anterior);
+    activos_acumulados += (double)procesos_en_indice * (horizonte - anterior);
+    
+    printf("=== SIMULACION DE EVENTOS DISCRETOS ===\n");
+    printf("Llegadas: %s", llegadas);
+    if (traza == NULL) {
+        printf(" (tasa %.3f, vida media %.3f)", tasa, vida);
+    }
+    printf("  Horizonte: %.1f  Semilla: %lu\n", horizonte, semilla);
+    printf("Memoria: %d KB, esquema %s, procesos de hasta %d KB, cola %s\n",
+           total, esquema, particion, nombres_cola[politica_cola]);
+    printf("Llegadas: %ld  Completados: %ld  Rechazados: %ld  En memoria al final: %d"
+           "  En espera al final: %d\n",
+           llegadas_totales, completados, rechazados, procesos_en_indice, longitud_cola);
+    printf("Utilizacion: %.2f%%  Procesos en memoria (media): %.2f\n",
+           100.0 * uso_acumulado / ((double)total * horizonte),
+           activos_acumulados / horizonte);
+    printf("Throughput: %.4f procesos por unidad de tiempo\n", completados / horizonte);
+    printf("Espera: media %.3f (%.3f entre los %ld que esperaron), maxima %.3f\n",
+           sim_admitidos > 0 ? sim_espera_total / sim_admitidos : 0.0,
+           sim_admitidos_cola > 0 ? sim_espera_total / sim_admitidos_cola : 0.0,
+           sim_admitidos_cola, sim_espera_maxima);
+    printf("Longitud media de la cola: %.3f\n", cola_acumulada / horizonte);
+    printf("Eventos: %ld en %.3f s (%.0f eventos/s)\n", eventos_procesados, segundos,
+           segundos > 0.0 ? eventos_procesados / segundos : 0.0);
+    
+    if (traza != NULL && traza != stdin) {
+        fclose(traza);
+    }
+    al_admitir_desde_cola = NULL;
+    destruir_estado();
+    return 0;
+}
+
+/* ==================== MODO DE PRUEBA DE RENDIMIENTO ==================== */
+
+/**
+ * Comparador de latencias para qsort
+ */
+int comparar_latencias(const void *a, const void *b) {
+    unsigned long x;
+    unsigned long y;
+    
+    x = *(const unsigned long *)a;
+    y = *(const unsigned long *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * Devuelve el percentil pedido (0..1) de muestras ya ordenadas
+ */
+unsigned long percentil(unsigned long *muestras, long cantidad, double fraccion) {
+    if (cantidad == 0) {
+        return 0;
+    }
+    return muestras[(long)(fraccion * (cantidad - 1))];
+}
+
+/**
+ * Ejecuta una carga sintetica sobre 'particiones' particiones e imprime una
+ * fila con operaciones por segundo, latencias de crear y cerrar y la
+ * fragmentacion interna y externa al terminar.
+ * Cargas: "llenado" (llenar y vaciar en orden aleatorio, en ciclos),
+ * "rotacion" (cerrar y crear al azar alrededor de la ocupacion objetivo,
+ * tras un llenado inicial que no se mide) y "rafagas" (rafagas de
+ * creaciones seguidas de rafagas de cierres). Llenado y rafagas ejecutan al
+ * menos 2 * particiones operaciones para completar un ciclo. Con
+ * 'variables' las particiones miden entre 1 y 2 * tamano_particion KB; con
+ * 'esquema' ESQUEMA_DINAMICO o ESQUEMA_BUDDY se usa ese motor sobre la
+ * misma memoria total y la ocupacion se cuenta en procesos de tamano maximo.
+ * Una creacion rechazada se trata como memoria llena
+ */
+void medir_carga(const char *carga, int particiones, long operaciones, double ocupacion,
+                 int variables, int esquema) {
+    int *vivos;
+    int capacidad;
+    int *tamanos;
+    int num_vivos;
+    unsigned long *lat_crear;
+    unsigned long *lat_cerrar;
+    long n_crear;
+    long n_cerrar;
+    long hechas;
+    int objetivo;
+    int rafaga;
+    int crear;
+    int lleno;
+    int resultado;
+    int j;
+    int id;
+    double t0;
+    double t1;
+    double inicio;
+    double total;
+    
+    if (strcmp(carga, "rotacion") != 0 && operaciones < 2L * particiones) {
+        operaciones = 2L * particiones;
+    }
+    
+    /* Sin particiones fijas caben tantos procesos como KB de memoria */
+    capacidad = esquema != ESQUEMA_PARTICIONES ? particiones * tamano_particion : particiones;
+    vivos = (int *)malloc(capacidad * sizeof(int));
+    lat_crear = (unsigned long *)malloc(operaciones * sizeof(unsigned long));
+    lat_cerrar = (unsigned long *)malloc(operaciones * sizeof(unsigned long));
+    if (vivos == NULL || lat_crear == NULL || lat_cerrar == NULL) {
+        printf("Error: No se pudo asignar memoria para la prueba.\n");
+        free(vivos);
+        free(lat_crear);
+        free(lat_cerrar);
+        return;
+    }
+    
+    if (esquema == ESQUEMA_DINAMICO) {
+        configurar_dinamica(particiones * tamano_particion, tamano_particion);
+    } else if (esquema == ESQUEMA_BUDDY) {
+        configurar_buddy(particiones * tamano_particion, tamano_particion);
+    } else if (variables) {
+        tamanos = (int *)malloc(particiones * sizeof(int));
+        if (tamanos == NULL) {
+            printf("Error: No se pudo asignar memoria para la prueba.\n");
+            free(vivos);
+            free(lat_crear);
+            free(lat_cerrar);
+            return;
+        }
+        for (j = 0; j < particiones; j++) {
+            tamanos[j] = aleatorio_entre(1, 2 * tamano_particion);
+        }
+        configurar_particiones_variables(particiones, tamanos);
+        free(tamanos);
+    } else {
+        configurar_memoria(particiones * tamano_particion, tamano_particion);
+    }
+    num_vivos = 0;
+    lleno = 0;
+    n_crear = 0;
+    n_cerrar = 0;
+    hechas = 0;
+    rafaga = 0;
+    crear = 1;
+    objetivo = (int)(particiones * ocupacion);
+    if (objetivo < 1) {
+        objetivo = 1;
+    }
+    
+    /* La rotacion se mide a partir de la ocupacion objetivo */
+    if (strcmp(carga, "rotacion") == 0) {
+        while (num_vivos < objetivo) {
+            id = contador_procesos;
+            if (asignar_proceso(aleatorio_entre(1, tamano_particion)) < 0) {
+                break;
+            }
+            vivos[num_vivos++] = id;
+        }
+    }
+    
+    inicio = tiempo_ns();
+    while (hechas < operaciones) {
+        /* Decidir la siguiente operacion segun la carga */
+        if (strcmp(carga, "llenado") == 0) {
+            if (lleno) {
+                crear = 0;
+            } else if (num_vivos == 0) {
+                crear = 1;
+            }
+        } else if (strcmp(carga, "rotacion") == 0) {
+            if (num_vivos < objetivo) {
+                crear = 1;
+            } else if (num_vivos > objetivo) {
+                crear = 0;
+            } else {
+                crear = (int)(siguiente_aleatorio() & 1);
+            }
+        } else {
+            if (rafaga == 0) {
+                crear = !crear;
+                rafaga = aleatorio_entre(1, particiones / 4 + 1);
+            }
+            rafaga--;
+        }
+        
+        /* Nunca crear con la memoria llena ni cerrar con la memoria vacia */
+        if (lleno && num_vivos > 0) {
+            crear = 0;
+        } else if (num_vivos == 0) {
+            crear = 1;
+        }
+        
+        if (crear) {
+            id = contador_procesos;
+            t0 = tiempo_ns();
+            resultado = asignar_proceso(aleatorio_entre(1, tamano_particion));
+            t1 = tiempo_ns();
+            lat_crear[n_crear++] = (unsigned long)(t1 - t0);
+            if (resultado >= 0) {
+                vivos[num_vivos++] = id;
+            }
+            lleno = resultado < 0 || num_vivos == capacidad;
+        } else {
+            /* Cerrar un proceso vivo elegido al azar */
+            j = aleatorio_entre(0, num_vivos - 1);
+            id = vivos[j];
+            vivos[j] = vivos[--num_vivos];
+            t0 = tiempo_ns();
+            liberar_proceso(id);
+            t1 = tiempo_ns();
+            lat_cerrar[n_cerrar++] = (unsigned long)(t1 - t0);
+            lleno = 0;
+        }
+        hechas++;
+    }
+    total = (tiempo_ns() - inicio) / 1e9;
+    
+    qsort(lat_crear, n_crear, sizeof(unsigned long), comparar_latencias);
+    qsort(lat_cerrar, n_cerrar, sizeof(unsigned long), comparar_latencias);
+    
+    printf("%-9s %11d %12.0f %8lu %8lu %8lu %8lu %8lu %8lu %6.1f %6.1f\n",
+           carga, particiones, total > 0.0 ? hechas / total : 0.0,
+           percentil(lat_crear, n_crear, 0.50),
+           percentil(lat_crear, n_crear, 0.99),
+           percentil(lat_crear, n_crear, 0.999),
+           percentil(lat_cerrar, n_cerrar, 0.50),
+           percentil(lat_cerrar, n_cerrar, 0.99),
+           percentil(lat_cerrar, n_cerrar, 0.999),
+           fragmentacion_interna_total(), fragmentacion_externa());
+    
+    destruir_estado();
+    free(vivos);
+    free(lat_crear);
+    free(lat_cerrar);
+}
+
+/**
+ * Mide el recorrido lineal de la tabla en formato por filas (arreglo de
+ * Particion) y por columnas. Ambos cuentan las particiones libres de al
+ * menos 'tamano_particion' KB, que es lo que consulta un ajuste lineal,
+ * sobre particiones variables ocupadas a la mitad al azar; por columnas se
+ * recorren las palabras de estado y solo se leen los tamanos de las libres.
+ * Imprime particiones recorridas por segundo y los bytes de tabla leidos
+ * por segundo: por filas, la fila entera; por columnas, las palabras de
+ * estado y el tamano de cada libre
+ */
+void medir_recorrido(int particiones) {
+    Particion *filas;
+    const unsigned long *ocupadas;
+    const int *tamanos;
+    unsigned long palabra;
+    long repeticiones;
+    long r;
+    long en_filas;
+    long en_columnas;
+    long libres;
+    int *tamanos_nuevos;
+    int umbral;
+    int i;
+    double inicio;
+    double seg_filas;
+    double seg_columnas;
+    double bytes_filas;
+    double bytes_columnas;
+    
+    tamanos_nuevos = (int *)calloc(particiones, sizeof(int));
+    filas = (Particion *)malloc(particiones * sizeof(Particion));
+    if (tamanos_nuevos == NULL || filas == NULL) {
+        printf("Error: No se pudo asignar memoria para la prueba.\n");
+        free(tamanos_nuevos);
+        free(filas);
+        return;
+    }
+    umbral = tamano_particion;
+    for (i = 0; i < particiones; i++) {
+        tamanos_nuevos[i] = aleatorio_entre(1, 2 * tamano_particion);
+    }
+    configurar_particiones_variables(particiones, tamanos_nuevos);
+    free(tamanos_nuevos);
+    libres = particiones;
+    for (i = 0; i < particiones; i++) {
+        if (siguiente_aleatorio() & 1) {
+            ocupar_particion(i);
+            libres--;
+        }
+    }
+    
+    /* La misma tabla copiada en el formato por filas */
+    for (i = 0; i < particiones; i++) {
+        filas[i].id = i;
+        filas[i].id_proceso = tabla_particiones.id_proceso[i];
+        filas[i].direccion_inicio = tabla_particiones.direccion_inicio[i];
+        filas[i].tamano = tabla_particiones.tamano[i];
+        filas[i].estado = estado_particion(i);
+        filas[i].tamano_usado = tabla_particiones.tamano_usado[i];
+        filas[i].proceso = tabla_particiones.proceso[i];
+    }
+    
+    /* Unas 50 millones de particiones recorridas por formato */
+    repeticiones = 50000000L / particiones;
+    if (repeticiones < 1) {
+        repeticiones = 1;
+    }
+    
+    en_filas = 0;
+    inicio = tiempo_ns();
+    for (r = 0; r < repeticiones; r++) {
+        for (i = 0; i < particiones; i++) {
+            en_filas += (filas[i].estado == 0) & (filas[i].tamano >= umbral);
+        }
+    }
+    seg_filas = (tiempo_ns() - inicio) / 1e9;
+    
+    ocupadas = tabla_particiones.ocupadas;
+    tamanos = tabla_particiones.tamano;
+    en_columnas = 0;
+    palabra = 0;
+    inicio = tiempo_ns();
+    for (r = 0; r < repeticiones; r++) {
+        for (i = 0; i < particiones; i += BITS_POR_PALABRA) {
+            /* Solo se leen los tamanos de las particiones libres */
+            palabra = ~ocupadas[i / BITS_POR_PALABRA];
+            if (particiones - i < BITS_POR_PALABRA) {
+                palabra &= (1UL << (particiones - i)) - 1;
+            }
+            while (palabra != 0) {
+                en_columnas += tamanos[i + primer_bit(palabra)] >= umbral;
+                palabra &= palabra - 1;
+            }
+        }
+    }
+    seg_columnas = (tiempo_ns() - inicio) / 1e9;
+    
+    /* Bytes de tabla que lee cada recorrido */
+    bytes_filas = (double)sizeof(Particion) * particiones * repeticiones;
+    bytes_columnas = ((double)sizeof(unsigned long) *
+                      ((particiones + BITS_POR_PALABRA - 1) / BITS_POR_PALABRA) +
+                      (double)sizeof(int) * libres) * repeticiones;
+    printf("%11d %10.0f %9.2f %10.0f %9.2f %11.2fx %s\n", particiones,
+           seg_filas > 0.0 ? particiones * (double)repeticiones / seg_filas / 1e6 : 0.0,
+           seg_filas > 0.0 ? bytes_filas / seg_filas / 1e9 : 0.0,
+           seg_columnas > 0.0 ? particiones * (double)repeticiones / seg_columnas / 1e6 : 0.0,
+           seg_columnas > 0.0 ? bytes_columnas / seg_columnas / 1e9 : 0.0,
+           seg_columnas > 0.0 ? seg_filas / seg_columnas : 0.0,
+           en_filas == en_columnas ? "ok" : "ERROR");
+    
+    destruir_estado();
+    free(filas);
+}
+
+/**
+ * Prueba de rendimiento reproducible. Opciones 'clave=valor':
+ *   carga=llenado|rotacion|rafagas|todas  (todas)
+ *   semilla=N       semilla fija del generador (12345)
+ *   ops=N           operaciones por medicion (200000)
+ *   min=N max=N     rango de particiones, en potencias de 10 (10 .. 1000000)
+ *   particion=N     tamano de cada particion en KB (4)
+ *   ocupacion=F     ocupacion objetivo de "rotacion" (0.5)
+ *   politica=P      primer | mejor | peor | siguiente (primer)
+ *   variable=1      particiones de tamano aleatorio entre 1 y 2 * particion
+ *   dinamico=1      particionamiento dinamico con la misma memoria total
+ *   buddy=1         sistema de companeros con la misma memoria total
+ *   recorrido=1     en lugar de las cargas, compara el recorrido de la
+ *                   tabla por filas y por columnas
+ */
+int ejecutar_benchmark(int argc, char *argv[]) {
+    const char *cargas[3];
+    const char *carga;
+    unsigned long semilla;
+    long operaciones;
+    long minimo;
+    long maximo;
+    long n;
+    int particion;
+    double ocupacion;
+    int variables;
+    int esquema;
+    int recorrido;
+    int i;
+    
+    cargas[0] = "llenado";
+    cargas[1] = "rotacion";
+    cargas[2] = "rafagas";
+    carga = "todas";
+    semilla = 12345;
+    operaciones = 200000;
+    minimo = 10;
+    maximo = 1000000;
+    particion = 4;
+    ocupacion = 0.5;
+    variables = 0;
+    esquema = ESQUEMA_PARTICIONES;
+    recorrido = 0;
+    politica_actual = &politicas[0];
+    guardar_terminados = 0;  /* El historial creceria con cada cierre medido */
+    
+    for (i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "carga=", 6) == 0) {
+            carga = argv[i] + 6;
+        } else if (strncmp(argv[i], "semilla=", 8) == 0) {
+            semilla = strtoul(argv[i] + 8, NULL, 10);
+        } else if (strncmp(argv[i], "ops=", 4) == 0) {
+            operaciones = strtol(argv[i] + 4, NULL, 10);
+        } else if (strncmp(argv[i], "min=", 4) == 0) {
+            minimo = strtol(argv[i] + 4, NULL, 10);
+        } else if (strncmp(argv[i], "max=", 4) == 0) {
+            maximo = strtol(argv[i] + 4, NULL, 10);
+        } else if (strncmp(argv[i], "particion=", 10) == 0) {
+            particion = (int)strtol(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "ocupacion=", 10) == 0) {
+            ocupacion = strtod(argv[i] + 10, NULL);
+        } else if (strncmp(argv[i], "politica=", 9) == 0) {
+            politica_actual = buscar_politica(argv[i] + 9);
+            if (politica_actual == NULL) {
+                printf("Error: politica desconocida '%s'.\n", argv[i] + 9);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "variable=", 9) == 0) {
+            variables = (int)strtol(argv[i] + 9, NULL, 10) != 0;
+        } else if (strncmp(argv[i], "dinamico=", 9) == 0) {
+            if (strtol(argv[i] + 9, NULL, 10) != 0) {
+                esquema = ESQUEMA_DINAMICO;
+            }
+        } else if (strncmp(argv[i], "buddy=", 6) == 0) {
+            if (strtol(argv[i] + 6, NULL, 10) != 0) {
+                esquema = ESQUEMA_BUDDY;
+            }
+        } else if (strncmp(argv[i], "recorrido=", 10) == 0) {
+            recorrido = (int)strtol(argv[i] + 10, NULL, 10) != 0;
+        } else {
+            printf("Error: opcion desconocida '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (operaciones <= 0 || minimo <= 0 || maximo < minimo || particion <= 0 ||
+        ocupacion <= 0.0 || ocupacion > 1.0 || maximo > INT_MAX / particion / 2) {
+        printf("Error: parametros de la prueba invalidos.\n");
+        return 1;
+    }
+    if (strcmp(carga, "todas") != 0 && strcmp(carga, cargas[0]) != 0 &&
+        strcmp(carga, cargas[1]) != 0 && strcmp(carga, cargas[2]) != 0) {
+        printf("Error: carga desconocida '%s'.\n", carga);
+        return 1;
+    }
+    
+    printf("=== PRUEBA DE RENDIMIENTO ===\n");
+    if (recorrido) {
+        printf("Recorrido lineal de la tabla de particiones (semilla %lu)\n", semilla);
+        printf("Bytes por particion: filas %d, columnas %.3f\n", (int)sizeof(Particion),
+               (double)sizeof(int) + 1.0 / CHAR_BIT);
+        printf("%11s %20s %20s %12s\n", "", "Filas", "Columnas", "");
+        printf("%11s %10s %9s %10s %9s %12s %s\n", "Particiones", "Mpart/s", "GB/s",
+               "Mpart/s", "GB/s", "Aceleracion", "Conteo");
+        for (n = minimo; n <= maximo; n *= 10) {
+            semilla_aleatoria(semilla);
+            tamano_particion = particion;
+            medir_recorrido((int)n);
+        }
+        return 0;
+    }
+    printf("Semilla: %lu  Operaciones por medicion: %ld  Particion: %d KB%s\n",
+           semilla, operaciones, particion,
+           esquema == ESQUEMA_DINAMICO ? " (dinamica)" :
+           (esquema == ESQUEMA_BUDDY ? " (buddy)" : (variables ? " (variable)" : "")));
+    if (esquema == ESQUEMA_DINAMICO) {
+        printf("Politica: Ajuste segregado por clases de tamano\n");
+    } else if (esquema == ESQUEMA_BUDDY) {
+        printf("Politica: Menor bloque de potencia de 2 suficiente\n");
+    } else {
+        printf("Politica: %s\n", politica_actual->descripcion);
+    }
+    printf("%-9s %11s %12s %26s %26s %13s\n", "", "", "",
+           "Crear (ns)", "Cerrar (ns)", "Frag. (%)");
+    printf("%-9s %11s %12s %8s %8s %8s %8s %8s %8s %6s %6s\n", "Carga", "Particiones",
+           "Ops/s", "p50", "p99", "p999", "p50", "p99", "p999", "int", "ext");
+    
+    for (i = 0; i < 3; i++) {
+        if (strcmp(carga, "todas") != 0 && strcmp(carga, cargas[i]) != 0) {
+            continue;
+        }
+        for (n = minimo; n <= maximo; n *= 10) {
+            /* Cada medicion parte de la misma semilla */
+            semilla_aleatoria(semilla);
+            tamano_particion = particion;
+            medir_carga(cargas[i], (int)n, operaciones, ocupacion, variables, esquema);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Muestra las opciones de linea de comandos
+ */
+void mostrar_uso(const char *programa) {
+    printf("Uso: %s [--compacta] ...  memoria sin vector por KB (aplica a todos los modos)\n", programa);
+    printf("     %s                 menu interactivo\n", programa);
+    printf("     %s --cargar <archivo>  menu interactivo desde una instantanea\n", programa);
+    printf("     %s --lote <traza>  ejecuta una traza ('-' = entrada estandar)\n", programa);
+    printf("     %s --bench [clave=valor ...]  prueba de rendimiento\n", programa);
+    printf("     %s --sim [clave=valor ...]    simulacion de eventos discretos\n", programa);
+    printf("     %s --concurrente [clave=valor ...]  asignacion con 1 a N hilos\n", programa);
+    printf("     %s --paginacion [clave=valor ...]   TLB y tablas de paginas\n", programa);
+    printf("     %s --reemplazo traza=<archivo> [clave=valor ...]  fallos de pagina\n",
+           programa);
+}
+
+/* ==================== MODO CONCURRENTE ==================== */
+
+/**
+ * Reserva 'bytes' con el inicio alineado a LINEA_CACHE (malloc no lo
+ * garantiza). En 'bloque' queda el puntero que hay que pasar a free()
+ */
+void *reservar_alineado(size_t bytes, void **bloque) {
+    size_t direccion;
+    
+    *bloque = malloc(bytes + LINEA_CACHE - 1);
+    if (*bloque == NULL) {
+        return NULL;
+    }
+    direccion = (size_t)*bloque;
+    return (char *)*bloque + (LINEA_CACHE - direccion % LINEA_CACHE) % LINEA_CACHE;
+}
+
+/**
+ * Reclama una particion libre recorriendo las ranuras desde 'desde': su
+ * estado pasa de 0 a 1 con compare-and-swap, de modo que dos hilos nunca
+ * obtienen la misma. Cada estado tiene su propia linea, asi que los
+ * reclamos de particiones distintas no compiten por la misma palabra.
+ * Devuelve su indice o -1 si no hay libres
+ */
+int reclamar_particion(int desde, long *reintentos) {
+#if defined(HILOS_DISPONIBLES)
+    int esperado;
+    int i;
+    int n;
+    
+    i = desde;
+    for (n = 0; n < num_particiones; n++) {
+        /* Lectura relajada antes del CAS: las ocupadas se saltan sin
+         * invalidar su linea de cache en los demas nucleos */
+        esperado = 0;
+        if (__atomic_load_n(&ranuras[i].estado, __ATOMIC_RELAXED) == 0) {
+            if (__atomic_compare_exchange_n(&ranuras[i].estado, &esperado, 1, 0,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return i;
+            }
+            (*reintentos)++;
+        }
+        i++;
+        if (i == num_particiones) {
+            i = 0;
+        }
+    }
+#else
+    (void)desde;
+    (void)reintentos;
+#endif
+    return -1;
+}
+
+/**
+ * Marca como ocupada una particion ya reservada por el hilo (obtenida de
+ * su almacen). Ningun otro hilo la toca mientras este en el almacen
+ */
+void tomar_particion(int particion) {
+#if defined(HILOS_DISPONIBLES)
+    __atomic_store_n(&ranuras[particion].estado, 1, __ATOMIC_RELAXED);
+#else
+    ranuras[particion].estado = 1;
+#endif
+}
+
+/**
+ * Devuelve una particion reclamada: primero se limpian sus datos y despues
+ * se publica el estado libre con semantica de liberacion
+ */
+void soltar_particion(int particion) {
+    if (memoria != NULL) {
+        llenar_celdas(memoria + tabla_particiones.direccion_inicio[particion],
+                      ranuras[particion].tamano_usado, -1);
+    }
+    ranuras[particion].id_proceso = -1;
+    ranuras[particion].tamano_usado = 0;
+#if defined(HILOS_DISPONIBLES)
+    __atomic_store_n(&ranuras[particion].estado, 0, __ATOMIC_RELEASE);
+#else
+    ranuras[particion].estado = 0;
+#endif
+}
+
+/**
+ * Mueve hasta 'cantidad' particiones del final de un arreglo al de otro.
+ * Devuelve cuantas movio
+ */
+int mover_particiones(int *origen, int *en_origen, int *destino, int *en_destino,
+                      int cantidad) {
+    int movidas;
+    
+    if (cantidad > *en_origen) {
+        cantidad = *en_origen;
+    }
+    for (movidas = 0; movidas < cantidad; movidas++) {
+        destino[(*en_destino)++] = origen[--(*en_origen)];
+    }
+    return movidas;
+}
+
+/**
+ * Llena el almacen vacio de un hilo: primero con un lote del deposito
+ * global y, si este se agoto, robando la mitad del almacen de otro hilo.
+ * Devuelve 0 si no encontro ninguna particion libre
+ */
+int recargar_almacen(TrabajoHilo *trabajo) {
+#if defined(HILOS_DISPONIBLES)
+    TrabajoHilo *victima;
+    int botin[TAMANO_ALMACEN];
+    int en_botin;
+    int k;
+    
+    pthread_mutex_lock(&trabajo->cerrojo);
+    pthread_mutex_lock(&cerrojo_deposito);
+    mover_particiones(deposito, &en_deposito, trabajo->almacen, &trabajo->en_almacen,
+                      LOTE_ALMACEN);
+    pthread_mutex_unlock(&cerrojo_deposito);
+    pthread_mutex_unlock(&trabajo->cerrojo);
+    if (trabajo->en_almacen > 0) {
+        return 1;
+    }
+    
+    /* Robo: se recorre el resto de los hilos empezando por el siguiente. El
+     * botin pasa por un arreglo local para no sostener dos cerrojos de
+     * almacen a la vez (dos hilos robandose mutuamente se bloquearian) */
+    for (k = 1; k < num_trabajos_hilos; k++) {
+        victima = &trabajos_hilos[(trabajo->indice + k) % num_trabajos_hilos];
+        en_botin = 0;
+        pthread_mutex_lock(&victima->cerrojo);
+        mover_particiones(victima->almacen, &victima->en_almacen, botin, &en_botin,
+                          (victima->en_almacen + 1) / 2);
+        pthread_mutex_unlock(&victima->cerrojo);
+        if (en_botin > 0) {
+            pthread_mutex_lock(&trabajo->cerrojo);
+            mover_particiones(botin, &en_botin, trabajo->almacen, &trabajo->en_almacen,
+                              en_botin);
+            pthread_mutex_unlock(&trabajo->cerrojo);
+            trabajo->robos++;
+            return 1;
+        }
+    }
+    trabajo->reintentos++;
+#else
+    (void)trabajo;
+#endif
+    return 0;
+}
+
+/**
+ * Toma una particion libre del almacen del hilo (recargandolo si esta
+ * vacio). Devuelve -1 si no hay particiones libres en ningun lado
+ */
+int obtener_de_almacen(TrabajoHilo *trabajo) {
+    int particion;
+    
+    particion = -1;
+#if defined(HILOS_DISPONIBLES)
+    /* El cerrojo propio no tiene disputa salvo durante un robo */
+    pthread_mutex_lock(&trabajo->cerrojo);
+    if (trabajo->en_almacen > 0) {
+        particion = trabajo->almacen[--trabajo->en_almacen];
+    }
+    pthread_mutex_unlock(&trabajo->cerrojo);
+    if (particion == -1 && recargar_almacen(trabajo)) {
+        pthread_mutex_lock(&trabajo->cerrojo);
+        if (trabajo->en_almacen > 0) {
+            particion = trabajo->almacen[--trabajo->en_almacen];
+        }
+        pthread_mutex_unlock(&trabajo->cerrojo);
+    }
+#else
+    (void)trabajo;
+#endif
+    return particion;
+}
+
+/**
+ * Guarda una particion liberada en el almacen del hilo; si esta lleno,
+ * primero devuelve un lote al deposito global
+ */
+void devolver_a_almacen(TrabajoHilo *trabajo, int particion) {
+#if defined(HILOS_DISPONIBLES)
+    pthread_mutex_lock(&trabajo->cerrojo);
+    if (trabajo->en_almacen == TAMANO_ALMACEN) {
+        pthread_mutex_lock(&cerrojo_deposito);
+        mover_particiones(trabajo->almacen, &trabajo->en_almacen, deposito, &en_deposito,
+                          LOTE_ALMACEN);
+        pthread_mutex_unlock(&cerrojo_deposito);
     }
-    
-    temp = actual;
-    free(temp);
-    return 1;  /* Eliminacion exitosa */
+    trabajo->almacen[trabajo->en_almacen++] = particion;
+    pthread_mutex_unlock(&trabajo->cerrojo);
+#else
+    (void)trabajo;
+    (void)particion;
+#endif
 }
 
 /**
- * Busca un proceso en la lista por su ID
+ * Cuerpo de cada hilo: crea y cierra procesos al azar. En modo CAS reclama
+ * particiones en la tabla compartida con compare-and-swap del estado; en
+ * modo almacen las toma de su almacen local. En ambos los IDs salen de un
+ * contador atomico y los datos de una particion solo los toca el hilo que
+ * la obtuvo
  */
-Proceso* buscar_proceso(int id) {
-    Proceso *actual;
+void *trabajador_concurrente(void *argumento) {
+    TrabajoHilo *trabajo;
+    long hecho;
+    int particion;
+    int id;
+    int j;
+    int tamano;
     
-    actual = lista_procesos;
-    while (actual != NULL) {
-        if (actual->id == id) {
-            return actual;
+    trabajo = (TrabajoHilo *)argumento;
+    for (hecho = 0; hecho < trabajo->operaciones; hecho++) {
+        if (trabajo->num_propias < trabajo->limite &&
+            (trabajo->num_propias == 0 || (aleatorio_de(&trabajo->semilla) & 1))) {
+            if (trabajo->modo == CONCURRENCIA_ALMACEN) {
+                particion = obtener_de_almacen(trabajo);
+                if (particion >= 0) {
+                    tomar_particion(particion);
+                }
+            } else {
+                particion = reclamar_particion((int)(aleatorio_de(&trabajo->semilla) %
+                                                     (unsigned long)num_particiones),
+                                               &trabajo->reintentos);
+            }
+            if (particion < 0) {
+                continue;
+            }
+#if defined(HILOS_DISPONIBLES)
+            id = __atomic_fetch_add(&contador_procesos, 1, __ATOMIC_RELAXED);
+#else
+            id = contador_procesos++;
+#endif
+            tamano = 1 + (int)(aleatorio_de(&trabajo->semilla) %
+                               (unsigned long)tabla_particiones.tamano[particion]);
+            ranuras[particion].id_proceso = id;
+            ranuras[particion].tamano_usado = tamano;
+            if (memoria != NULL) {
+                llenar_celdas(memoria + tabla_particiones.direccion_inicio[particion],
+                              tamano, id);
+            }
+            trabajo->propias[trabajo->num_propias++] = particion;
+            trabajo->creados++;
+        } else {
+            j = (int)(aleatorio_de(&trabajo->semilla) % (unsigned long)trabajo->num_propias);
+            particion = trabajo->propias[j];
+            trabajo->propias[j] = trabajo->propias[--trabajo->num_propias];
+            soltar_particion(particion);
+            if (trabajo->modo == CONCURRENCIA_ALMACEN) {
+                devolver_a_almacen(trabajo, particion);
+            }
+            trabajo->cerrados++;
         }
-        actual = actual->siguiente;
     }
     return NULL;
 }
 
-/* ==================== FUNCIONES DE GESTION DE MEMORIA ==================== */
-
 /**
- * Inicializa el sistema de memoria particionada
+ * Reparte 'operaciones' entre 'hilos' hilos sobre particiones iguales y
+ * mide el rendimiento conjunto. Al terminar comprueba que cada particion
+ * este exactamente en un lugar (deposito, un almacen o un proceso), que las
+ * ocupadas coincidan con las que conservan los hilos y que no se repitan
+ * IDs. Devuelve 0 si algo fallo
  */
-void inicializar_memoria(void) {
+int medir_concurrencia(int modo, int hilos, int particiones, long operaciones,
+                       double ocupacion, unsigned long semilla, double *ops_por_segundo,
+                       long *reintentos, long *robos) {
+#if defined(HILOS_DISPONIBLES)
+    pthread_t *ids_hilos;
+    TrabajoHilo *trabajos;
+    void *bloque_trabajos;
+    void *bloque_ranuras;
+    unsigned char *vistas;
+    double inicio;
+    double segundos;
+    long creados;
+    long ocupadas;
+    long conservadas;
+    int limite;
+    int lanzados;
+    int correcto;
     int i;
+    int j;
     
-    printf("\n=== INICIALIZACION DEL SISTEMA DE MEMORIA ===\n");
+    configurar_memoria(particiones * tamano_particion, tamano_particion);
+    contador_procesos = 1;
+    limite = (int)(particiones * ocupacion / hilos);
+    if (limite < 1) {
+        limite = 1;
+    }
     
-    /* Solicitar tamano total de memoria */
-    do {
-        printf("Ingrese el tamano total de memoria (KB): ");
-        scanf("%d", &tamano_total_memoria);
-        if (tamano_total_memoria <= 0) {
-            printf("Error: El tamano debe ser mayor a 0.\n");
-        }
-    } while (tamano_total_memoria <= 0);
+    ids_hilos = (pthread_t *)malloc(hilos * sizeof(pthread_t));
+    trabajos = (TrabajoHilo *)reservar_alineado(hilos * sizeof(TrabajoHilo), &bloque_trabajos);
+    ranuras = (RanuraConcurrente *)reservar_alineado(particiones * sizeof(RanuraConcurrente),
+                                                     &bloque_ranuras);
+    deposito = (int *)malloc(particiones * sizeof(int));
+    vistas = (unsigned char *)calloc(particiones, 1);
+    if (ids_hilos == NULL || trabajos == NULL || ranuras == NULL || deposito == NULL ||
+        vistas == NULL) {
+        free(ids_hilos);
+        free(bloque_trabajos);
+        free(bloque_ranuras);
+        ranuras = NULL;
+        free(deposito);
+        free(vistas);
+        deposito = NULL;
+        destruir_estado();
+        return 0;
+    }
+    memset(trabajos, 0, hilos * sizeof(TrabajoHilo));
+    for (i = 0; i < particiones; i++) {
+        ranuras[i].estado = 0;
+        ranuras[i].id_proceso = -1;
+        ranuras[i].tamano_usado = 0;
+    }
     
-    /* Solicitar tamano de cada particion */
-    do {
-        printf("Ingrese el tamano de cada particion (KB): ");
-        scanf("%d", &tamano_particion);
-        if (tamano_particion <= 0) {
-            printf("Error: El tamano debe ser mayor a 0.\n");
-        } else if (tamano_particion > tamano_total_memoria) {
-            printf("Error: El tamano de particion no puede ser mayor que la memoria total.\n");
-            tamano_particion = 0;
+    /* El deposito empieza con todas las particiones, la primera arriba */
+    en_deposito = 0;
+    if (modo == CONCURRENCIA_ALMACEN) {
+        for (i = particiones - 1; i >= 0; i--) {
+            deposito[en_deposito++] = i;
         }
-    } while (tamano_particion <= 0);
-    
-    /* Calcular numero de particiones */
-    num_particiones = tamano_total_memoria / tamano_particion;
-    
-    if (num_particiones == 0) {
-        printf("Error: No se pueden crear particiones con estos valores.\n");
-        exit(1);
     }
     
-    printf("\n>>> Se crearan %d particiones de %d KB cada una.\n", 
-           num_particiones, tamano_particion);
-    
-    /* Asignar memoria para el vector de RAM */
-    memoria = (int *)malloc(tamano_total_memoria * sizeof(int));
-    if (memoria == NULL) {
-        printf("Error: No se pudo asignar memoria.\n");
-        exit(1);
+    for (i = 0; i < hilos; i++) {
+        trabajos[i].operaciones = operaciones / hilos;
+        trabajos[i].limite = limite;
+        trabajos[i].modo = modo;
+        trabajos[i].indice = i;
+        trabajos[i].semilla = (semilla + 0x9E3779B9UL * (unsigned long)(i + 1)) & 0xFFFFFFFFUL;
+        if (trabajos[i].semilla == 0) {
+            trabajos[i].semilla = 1;
+        }
+        pthread_mutex_init(&trabajos[i].cerrojo, NULL);
+        trabajos[i].propias = (int *)malloc(limite * sizeof(int));
+        if (trabajos[i].propias == NULL) {
+            while (i >= 0) {
+                free(trabajos[i].propias);
+                pthread_mutex_destroy(&trabajos[i].cerrojo);
+                i--;
+            }
+            free(ids_hilos);
+            free(bloque_trabajos);
+            free(bloque_ranuras);
+            ranuras = NULL;
+            free(deposito);
+            free(vistas);
+            deposito = NULL;
+            destruir_estado();
+            return 0;
+        }
     }
+    trabajos_hilos = trabajos;
+    num_trabajos_hilos = hilos;
     
-    /* Inicializar vector de memoria con -1 (indica espacio libre) */
-    for (i = 0; i < tamano_total_memoria; i++) {
-        memoria[i] = -1;
+    inicio = tiempo_ns();
+    for (lanzados = 0; lanzados < hilos; lanzados++) {
+        if (pthread_create(&ids_hilos[lanzados], NULL, trabajador_concurrente,
+                           &trabajos[lanzados]) != 0) {
+            break;
+        }
     }
-    
-    /* Crear tabla de particiones */
-    tabla_particiones = (Particion *)malloc(num_particiones * sizeof(Particion));
-    if (tabla_particiones == NULL) {
-        printf("Error: No se pudo asignar memoria para la tabla de particiones.\n");
-        free(memoria);
-        exit(1);
+    for (i = 0; i < lanzados; i++) {
+        pthread_join(ids_hilos[i], NULL);
     }
+    segundos = (tiempo_ns() - inicio) / 1e9;
     
-    /* Inicializar cada particion */
-    for (i = 0; i < num_particiones; i++) {
-        tabla_particiones[i].id = i;
-        tabla_particiones[i].id_proceso = -1;  /* -1 indica libre */
-        tabla_particiones[i].direccion_inicio = i * tamano_particion;
-        tabla_particiones[i].tamano = tamano_particion;
-        tabla_particiones[i].estado = 0;  /* 0 = Libre */
+    /* Los estados y datos de las ranuras pasan a la tabla */
+    for (i = 0; i < particiones; i++) {
+        if (ranuras[i].estado) {
+            ocupar_particion(i);
+        }
+        tabla_particiones.id_proceso[i] = ranuras[i].id_proceso;
+        tabla_particiones.tamano_usado[i] = ranuras[i].tamano_usado;
     }
     
-    printf(">>> Memoria inicializada exitosamente.\n");
-}
-
-/**
- * Calcula el porcentaje de fragmentacion interna de una particion
- */
-float calcular_fragmentacion(int tamano_particion, int tamano_proceso) {
-    int fragmentacion;
-    
-    if (tamano_proceso == 0) {
-        return 0.0;
+    /* Verificacion: cada particion ocupada pertenece a exactamente un hilo
+     * y, con almacenes, cada libre esta en un unico almacen o en el deposito */
+    correcto = lanzados == hilos;
+    creados = 0;
+    conservadas = 0;
+    *reintentos = 0;
+    *robos = 0;
+    for (i = 0; i < hilos; i++) {
+        creados += trabajos[i].creados;
+        conservadas += trabajos[i].num_propias;
+        *reintentos += trabajos[i].reintentos;
+        *robos += trabajos[i].robos;
+        for (j = 0; j < trabajos[i].num_propias; j++) {
+            vistas[trabajos[i].propias[j]]++;
+        }
+        for (j = 0; j < trabajos[i].en_almacen; j++) {
+            vistas[trabajos[i].almacen[j]]++;
+        }
+    }
+    for (j = 0; j < en_deposito; j++) {
+        vistas[deposito[j]]++;
+    }
+    ocupadas = 0;
+    for (i = 0; i < particiones; i++) {
+        ocupadas += estado_particion(i);
+        if (vistas[i] != (modo == CONCURRENCIA_ALMACEN ? 1 : estado_particion(i))) {
+            correcto = 0;
+        }
     }
+    if (ocupadas != conservadas || contador_procesos != creados + 1) {
+        correcto = 0;
+    }
+    *ops_por_segundo = segundos > 0.0 ? (operaciones / hilos) * (double)hilos / segundos : 0.0;
     
-    fragmentacion = tamano_particion - tamano_proceso;
-    return (fragmentacion * 100.0) / tamano_particion;
+    for (i = 0; i < hilos; i++) {
+        free(trabajos[i].propias);
+        pthread_mutex_destroy(&trabajos[i].cerrojo);
+    }
+    trabajos_hilos = NULL;
+    num_trabajos_hilos = 0;
+    free(ids_hilos);
+    free(bloque_trabajos);
+    free(bloque_ranuras);
+    ranuras = NULL;
+    free(deposito);
+    free(vistas);
+    deposito = NULL;
+    en_deposito = 0;
+    destruir_estado();
+    return correcto;
+#else
+    (void)modo;
+    (void)hilos;
+    (void)particiones;
+    (void)operaciones;
+    (void)ocupacion;
+    (void)semilla;
+    *ops_por_segundo = 0.0;
+    *reintentos = 0;
+    *robos = 0;
+    return 0;
+#endif
 }
 
 /**
- * Crea un nuevo proceso usando el algoritmo Primer Ajuste
+ * Escalabilidad de la asignacion concurrente con 1, 2, 4, ... hilos, con
+ * reclamo por CAS sobre la tabla compartida y con almacenes por hilo.
+ * Opciones 'clave=valor':
+ *   modo=cas|almacen|ambos  estrategias a medir (ambos)
+ *   hilos=N         maximo de hilos, se duplica desde 1 (64)
+ *   particiones=N   particiones iguales compartidas (100000)
+ *   particion=N     tamano de cada particion en KB (4)
+ *   ops=N           operaciones totales por medicion, repartidas (4000000)
+ *   ocupacion=F     fraccion de particiones que pueden estar ocupadas (0.5)
+ *   semilla=N       semilla base; cada hilo deriva la suya (12345)
+ * Solo se ejercita la tabla de particiones: la tabla de procesos, su indice
+ * y las politicas de ubicacion siguen siendo de un solo hilo
  */
-void crear_proceso(void) {
-    int tamano_proceso;
-    int particion_asignada;
+int ejecutar_concurrente(int argc, char *argv[]) {
+    const char *modo;
+    const char *titulos[2];
+    unsigned long semilla;
+    long operaciones;
+    long reintentos;
+    long robos;
+    int maximo_hilos;
+    int particiones;
+    int particion;
+    int hilos;
+    int estrategia;
     int i;
-    int dir_inicio;
-    float fragmentacion;
-    
-    /* Generar tamano aleatorio para el proceso (entre 1 y el tamano de particion) */
-    tamano_proceso = (rand() % tamano_particion) + 1;
+    double ocupacion;
+    double ops;
+    double base;
     
-    printf("\n--- CREANDO NUEVO PROCESO ---\n");
-    printf("Proceso ID: %d\n", contador_procesos);
-    printf("Tamano requerido: %d KB\n", tamano_proceso);
+    modo = "ambos";
+    maximo_hilos = 64;
+    particiones = 100000;
+    particion = 4;
+    operaciones = 4000000;
+    ocupacion = 0.5;
+    semilla = 12345;
+    titulos[CONCURRENCIA_CAS] = "cas";
+    titulos[CONCURRENCIA_ALMACEN] = "almacen";
     
-    /* Algoritmo Primer Ajuste: buscar la primera particion libre donde quepa */
-    particion_asignada = -1;
-    for (i = 0; i < num_particiones; i++) {
-        if (tabla_particiones[i].estado == 0 && 
-            tabla_particiones[i].tamano >= tamano_proceso) {
-            particion_asignada = i;
-            break;  /* Primer ajuste: tomar la primera que sirva */
+    for (i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "modo=", 5) == 0) {
+            modo = argv[i] + 5;
+        } else if (strncmp(argv[i], "hilos=", 6) == 0) {
+            maximo_hilos = (int)strtol(argv[i] + 6, NULL, 10);
+        } else if (strncmp(argv[i], "particiones=", 12) == 0) {
+            particiones = (int)strtol(argv[i] + 12, NULL, 10);
+        } else if (strncmp(argv[i], "particion=", 10) == 0) {
+            particion = (int)strtol(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "ops=", 4) == 0) {
+            operaciones = strtol(argv[i] + 4, NULL, 10);
+        } else if (strncmp(argv[i], "ocupacion=", 10) == 0) {
+            ocupacion = strtod(argv[i] + 10, NULL);
+        } else if (strncmp(argv[i], "semilla=", 8) == 0) {
+            semilla = strtoul(argv[i] + 8, NULL, 10);
+        } else {
+            printf("Error: opcion desconocida '%s'.\n", argv[i]);
+            return 1;
         }
     }
-    
-    /* Verificar si se encontro una particion */
-    if (particion_asignada == -1) {
-        printf("ERROR: No hay particiones disponibles para el proceso.\n");
-        printf("       El proceso no pudo ser creado.\n");
-        return;
+    if (maximo_hilos < 1 || particiones < 1 || particion < 1 || operaciones < 1 ||
+        ocupacion <= 0.0 || ocupacion > 1.0 || particiones > INT_MAX / particion) {
+        printf("Error: parametros invalidos.\n");
+        return 1;
     }
-    
-    /* Asignar el proceso a la particion */
-    tabla_particiones[particion_asignada].estado = 1;  /* Ocupada */
-    tabla_particiones[particion_asignada].id_proceso = contador_procesos;
-    
-    /* Actualizar el vector de memoria con el ID del proceso */
-    dir_inicio = tabla_particiones[particion_asignada].direccion_inicio;
-    for (i = 0; i < tamano_proceso; i++) {
-        memoria[dir_inicio + i] = contador_procesos;
+    if (strcmp(modo, "ambos") != 0 && strcmp(modo, titulos[CONCURRENCIA_CAS]) != 0 &&
+        strcmp(modo, titulos[CONCURRENCIA_ALMACEN]) != 0) {
+        printf("Error: modo desconocido '%s'.\n", modo);
+        return 1;
     }
     
-    /* Agregar proceso a la lista enlazada */
-    agregar_proceso(contador_procesos, tamano_proceso, dir_inicio);
-    
-    /* Calcular fragmentacion interna */
-    fragmentacion = calcular_fragmentacion(tamano_particion, tamano_proceso);
+#if !defined(HILOS_DISPONIBLES)
+    printf("Error: el modo concurrente requiere hilos POSIX y operaciones atomicas.\n");
+    return 1;
+#endif
     
-    printf(">>> PROCESO CREADO EXITOSAMENTE <<<\n");
-    printf("    Asignado a la particion: %d\n", particion_asignada);
-    printf("    Direccion de inicio: %d\n", dir_inicio);
-    printf("    Fragmentacion interna: %.2f%%\n", fragmentacion);
+    printf("=== ASIGNACION CONCURRENTE ===\n");
+    printf("Particiones: %d de %d KB  Operaciones por medicion: %ld  Ocupacion: %.2f\n",
+           particiones, particion, operaciones, ocupacion);
+#if defined(_SC_NPROCESSORS_ONLN)
+    printf("Procesadores en linea: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    printf("Almacen por hilo: %d particiones, lotes de %d\n", TAMANO_ALMACEN, LOTE_ALMACEN);
+    printf("%-8s %-6s %12s %12s %12s %8s %s\n", "Modo", "Hilos", "Ops/s", "Aceleracion",
+           "Reintentos", "Robos", "Consistencia");
     
-    contador_procesos++;  /* Incrementar contador para el proximo proceso */
+    for (estrategia = CONCURRENCIA_CAS; estrategia <= CONCURRENCIA_ALMACEN; estrategia++) {
+        if (strcmp(modo, "ambos") != 0 && strcmp(modo, titulos[estrategia]) != 0) {
+            continue;
+        }
+        base = 0.0;
+        for (hilos = 1; hilos <= maximo_hilos; hilos *= 2) {
+            tamano_particion = particion;
+            i = medir_concurrencia(estrategia, hilos, particiones, operaciones, ocupacion,
+                                   semilla, &ops, &reintentos, &robos);
+            if (hilos == 1) {
+                base = ops;
+            }
+            printf("%-8s %-6d %12.0f %11.2fx %12ld %8ld %s\n", titulos[estrategia], hilos, ops,
+                   base > 0.0 ? ops / base : 0.0, reintentos, robos, i ? "ok" : "ERROR");
+            if (hilos > maximo_hilos / 2) {
+                break;  /* Duplicar pasaria el maximo (o desbordaria int) */
+            }
+        }
+    }
+    return 0;
 }
 
+/* ==================== PRUEBA DE PAGINACION ==================== */
+
 /**
- * Cierra un proceso y libera la particion
+ * Carga hasta 'procesos' procesos de 1 a 'maximo_proceso' KB en una
+ * memoria paginada y les hace 'referencias' referencias por turnos de
+ * CUANTO_PAGINACION, con la carga indicada:
+ *   secuencial  cada proceso recorre su espacio KB a KB
+ *   local       ventanas de 8 paginas que cambian de lugar cada tanto
+ *   aleatoria   direcciones uniformes en todo el proceso
+ * Muestra la tasa de aciertos del TLB y el tamano de las tablas de paginas
  */
-void cerrar_proceso(void) {
-    int id_proceso;
-    Proceso *proceso;
-    int particion_encontrada;
-    int i;
-    int dir_inicio;
-    
-    printf("\n--- CERRAR PROCESO ---\n");
-    printf("Ingrese el ID del proceso a cerrar: ");
-    scanf("%d", &id_proceso);
+void medir_paginacion(const char *carga, int total, int pagina, int procesos,
+                      long referencias, int maximo_proceso, unsigned long semilla) {
+    int *ids;
+    long *cursores;
+    long direccion;
+    long fisica;
+    long n;
+    long tamano;
+    long ventana;
+    long consultadas;
+    int cargados;
+    int id;
+    int k;
+    double inicio;
+    double segundos;
     
-    /* Buscar el proceso en la lista */
-    proceso = buscar_proceso(id_proceso);
-    if (proceso == NULL) {
-        printf("ERROR: No existe un proceso con ID %d.\n", id_proceso);
-        return;
+    semilla_aleatoria(semilla);
+    configurar_paginacion(total, pagina, maximo_proceso);
+    contador_procesos = 1;
+    ids = (int *)malloc(procesos * sizeof(int));
+    cursores = (long *)malloc(procesos * sizeof(long));
+    if (ids == NULL || cursores == NULL) {
+        printf("Error: No se pudo asignar memoria para la prueba.\n");
+        exit(1);
     }
-    
-    /* Buscar la particion que contiene el proceso */
-    particion_encontrada = -1;
-    for (i = 0; i < num_particiones; i++) {
-        if (tabla_particiones[i].id_proceso == id_proceso) {
-            particion_encontrada = i;
+    cargados = 0;
+    while (cargados < procesos) {
+        id = contador_procesos;
+        if (asignar_proceso(aleatorio_entre(1, maximo_proceso)) < 0) {
             break;
         }
+        cursores[cargados] = 0;
+        ids[cargados++] = id;
     }
-    
-    if (particion_encontrada == -1) {
-        printf("ERROR: No se encontro la particion del proceso.\n");
+    if (cargados == 0) {
+        printf("%-11s sin procesos: la memoria no alcanza\n", carga);
+        destruir_estado();
+        free(ids);
+        free(cursores);
         return;
     }
     
-    /* Liberar la particion */
-    tabla_particiones[particion_encontrada].estado = 0;  /* Libre */
-    tabla_particiones[particion_encontrada].id_proceso = -1;
-    
-    /* Limpiar el vector de memoria */
-    dir_inicio = tabla_particiones[particion_encontrada].direccion_inicio;
-    for (i = 0; i < tamano_particion; i++) {
-        if (memoria[dir_inicio + i] == id_proceso) {
-            memoria[dir_inicio + i] = -1;  /* Marcar como libre */
+    ventana = 8L * pagina;
+    tamano = 0;
+    k = 0;
+    inicio = tiempo_ns();
+    for (n = 0; n < referencias; n++) {
+        if (n % CUANTO_PAGINACION == 0) {
+            k = (int)((n / CUANTO_PAGINACION) % cargados);
+            tamano = buscar_proceso(ids[k])->tamano_requerido;
         }
+        if (carga[0] == 's') {
+            direccion = cursores[k];
+            cursores[k] = direccion + 1 < tamano ? direccion + 1 : 0;
+        } else if (carga[0] == 'l') {
+            if (aleatorio_entre(0, 99) < 2) {
+                cursores[k] = aleatorio_entre(0, (int)tamano - 1);
+            }
+            direccion = (cursores[k] + aleatorio_entre(0, (int)ventana - 1)) % tamano;
+        } else {
+            direccion = aleatorio_entre(0, (int)tamano - 1);
+        }
+        traducir_direccion(ids[k], direccion, &fisica);
     }
+    segundos = (tiempo_ns() - inicio) / 1e9;
     
-    /* Eliminar el proceso de la lista enlazada */
-    eliminar_proceso(id_proceso);
+    consultadas = tlb_aciertos + tlb_fallos;
+    printf("%-11s %9d %12ld %12.2f %12ld %10ld %12ld %11.3f %9.1f\n",
+           carga, cargados, consultadas,
+           consultadas > 0 ? 100.0 * tlb_aciertos / consultadas : 0.0, tlb_fallos,
+           entradas_tablas, entradas_tablas * (long)sizeof(int),
+           100.0 * entradas_tablas * (long)sizeof(int) / (estadisticas.kb_asignados * 1024.0),
+           segundos > 0.0 ? consultadas / segundos / 1e6 : 0.0);
     
-    printf(">>> PROCESO %d CERRADO EXITOSAMENTE <<<\n", id_proceso);
-    printf("    Particion %d liberada.\n", particion_encontrada);
+    destruir_estado();
+    free(ids);
+    free(cursores);
 }
 
 /**
- * Muestra la tabla de procesos activos
+ * Tasa de aciertos del TLB y sobrecarga de las tablas de paginas con
+ * cargas de referencias generadas. Opciones 'clave=valor':
+ *   memoria=N   memoria total en KB (262144)
+ *   pagina=N    tamano de pagina y de marco en KB (4)
+ *   tlb=N       entradas del TLB (64)
+ *   vias=N      entradas por conjunto; igual a tlb = totalmente asociativo (4)
+ *   procesos=N  procesos cargados (64)
+ *   maximo=N    tamano maximo de un proceso en KB (2048)
+ *   refs=N      referencias por carga (2000000)
+ *   carga=secuencial|local|aleatoria|todas  cargas a medir (todas)
+ *   semilla=N   semilla del generador (12345)
  */
-void mostrar_tabla_procesos(void) {
-    Proceso *actual;
+int ejecutar_paginacion(int argc, char *argv[]) {
+    const char *cargas[3];
+    const char *carga;
+    unsigned long semilla;
+    long referencias;
+    int total;
+    int pagina;
+    int entradas;
+    int vias;
+    int procesos;
+    int maximo;
+    int i;
     
-    printf("\n========== TABLA DE PROCESOS ==========\n");
-    printf("%-10s %-15s %-20s\n", "ID", "Tamano (KB)", "Direccion Inicio");
-    printf("--------------------------------------------------\n");
+    total = 262144;
+    pagina = 4;
+    entradas = TLB_ENTRADAS;
+    vias = TLB_VIAS;
+    procesos = 64;
+    maximo = 2048;
+    referencias = 2000000;
+    carga = "todas";
+    semilla = 12345;
+    cargas[0] = "secuencial";
+    cargas[1] = "local";
+    cargas[2] = "aleatoria";
     
-    if (lista_procesos == NULL) {
-        printf("No hay procesos activos.\n");
-    } else {
-        actual = lista_procesos;
-        while (actual != NULL) {
-            printf("%-10d %-15d %-20d\n", 
-                   actual->id, 
-                   actual->tamano_requerido, 
-                   actual->direccion_asignada);
-            actual = actual->siguiente;
+    for (i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "memoria=", 8) == 0) {
+            total = (int)strtol(argv[i] + 8, NULL, 10);
+        } else if (strncmp(argv[i], "pagina=", 7) == 0) {
+            pagina = (int)strtol(argv[i] + 7, NULL, 10);
+        } else if (strncmp(argv[i], "tlb=", 4) == 0) {
+            entradas = (int)strtol(argv[i] + 4, NULL, 10);
+        } else if (strncmp(argv[i], "vias=", 5) == 0) {
+            vias = (int)strtol(argv[i] + 5, NULL, 10);
+        } else if (strncmp(argv[i], "procesos=", 9) == 0) {
+            procesos = (int)strtol(argv[i] + 9, NULL, 10);
+        } else if (strncmp(argv[i], "maximo=", 7) == 0) {
+            maximo = (int)strtol(argv[i] + 7, NULL, 10);
+        } else if (strncmp(argv[i], "refs=", 5) == 0) {
+            referencias = strtol(argv[i] + 5, NULL, 10);
+        } else if (strncmp(argv[i], "carga=", 6) == 0) {
+            carga = argv[i] + 6;
+        } else if (strncmp(argv[i], "semilla=", 8) == 0) {
+            semilla = strtoul(argv[i] + 8, NULL, 10);
+        } else {
+            printf("Error: opcion desconocida '%s'.\n", argv[i]);
+            return 1;
         }
     }
-    printf("=======================================\n");
+    if (total < 1 || pagina < 1 || pagina > total || procesos < 1 || maximo < 1 ||
+        maximo > total || referencias < 1) {
+        printf("Error: parametros invalidos.\n");
+        return 1;
+    }
+    if (strcmp(carga, "todas") != 0 && strcmp(carga, cargas[0]) != 0 &&
+        strcmp(carga, cargas[1]) != 0 && strcmp(carga, cargas[2]) != 0) {
+        printf("Error: carga desconocida '%s'.\n", carga);
+        return 1;
+    }
+    if (!configurar_tlb(entradas, vias)) {
+        return 1;
+    }
+    free(tlb);
+    tlb = NULL;
+    
+    printf("=== PAGINACION Y TLB ===\n");
+    printf("Memoria: %d KB en marcos de %d KB  TLB: %d entradas, %d vias  "
+           "Cambio de proceso cada %d referencias\n",
+           total, pagina, tlb_entradas, tlb_vias, CUANTO_PAGINACION);
+    printf("%-11s %9s %12s %12s %12s %10s %12s %11s %9s\n", "Carga", "Procesos",
+           "Referencias", "Aciertos(%)", "Recorridos", "Entradas", "Tablas(B)",
+           "Sobrecarga%", "Mref/s");
+    for (i = 0; i < 3; i++) {
+        if (strcmp(carga, "todas") == 0 || strcmp(carga, cargas[i]) == 0) {
+            medir_paginacion(cargas[i], total, pagina, procesos, referencias, maximo, semilla);
+        }
+    }
+    return 0;
 }
 
 /**
- * Muestra la tabla de particiones con fragmentacion
+ * Reproduce una traza de referencias con la politica de reemplazo activa.
+ * Cada referencia es un numero de pagina o "proceso:pagina", separadas por
+ * espacios, comas o saltos de linea; '#' inicia un comentario. La traza se
+ * lee por bloques y se interpreta a mano, sin una llamada por referencia.
+ * Devuelve 0 si la traza tiene un caracter invalido
  */
-void mostrar_tabla_particiones(void) {
-    int i;
-    char *estado_str;
-    Proceso *proc;
-    float frag;
-    
-    printf("\n==================== TABLA DE PARTICIONES ====================\n");
-    printf("%-8s %-12s %-18s %-12s %-12s %-15s\n", 
-           "Part ID", "Estado", "Dir. Inicio (KB)", "Tamano (KB)", "ID Proceso", "Fragment. (%)");
-    printf("---------------------------------------------------------------\n");
+int reproducir_traza(FILE *traza, long *referencias) {
+    char *bufer;
+    size_t leidos;
+    size_t i;
+    long valor;
+    long cuenta;
+    int proceso;
+    int en_numero;
+    int en_comentario;
+    int correcta;
+    char c;
     
-    for (i = 0; i < num_particiones; i++) {
-        estado_str = tabla_particiones[i].estado == 0 ? "Libre" : "Ocupada";
-        
-        if (tabla_particiones[i].estado == 1) {
-            /* Calcular fragmentacion para particiones ocupadas */
-            proc = buscar_proceso(tabla_particiones[i].id_proceso);
-            frag = 0.0;
-            if (proc != NULL) {
-                frag = calcular_fragmentacion(tabla_particiones[i].tamano, 
-                                              proc->tamano_requerido);
+    bufer = (char *)malloc(TAMANO_LECTURA);
+    if (bufer == NULL) {
+        printf("Error: No se pudo asignar memoria para leer la traza.\n");
+        return 0;
+    }
+    valor = 0;
+    cuenta = 0;
+    proceso = -1;
+    en_numero = 0;
+    en_comentario = 0;
+    correcta = 1;
+    c = ' ';
+    while (correcta && (leidos = fread(bufer, 1, TAMANO_LECTURA, traza)) > 0) {
+        for (i = 0; i < leidos; i++) {
+            c = bufer[i];
+            if (en_comentario) {
+                en_comentario = c != '\n';
+            } else if (c >= '0' && c <= '9') {
+                valor = valor * 10 + (c - '0');
+                en_numero = 1;
+            } else if (c == ' ' || c == '\n' || c == ',' || c == '\t' || c == '\r' ||
+                       c == '#') {
+                if (en_numero) {
+                    referenciar_pagina(proceso < 0 ? 0 : proceso, valor);
+                    cuenta++;
+                } else if (proceso >= 0) {
+                    correcta = 0;
+                    break;
+                }
+                valor = 0;
+                proceso = -1;
+                en_numero = 0;
+                en_comentario = c == '#';
+            } else if (c == ':' && en_numero && proceso < 0 && valor <= INT_MAX) {
+                proceso = (int)valor;
+                valor = 0;
+                en_numero = 0;
+            } else {
+                correcta = 0;
+                break;
             }
-            
-            printf("%-8d %-12s %-18d %-12d %-12d %-15.2f\n",
-                   tabla_particiones[i].id,
-                   estado_str,
-                   tabla_particiones[i].direccion_inicio,
-                   tabla_particiones[i].tamano,
-                   tabla_particiones[i].id_proceso,
-                   frag);
-        } else {
-            printf("%-8d %-12s %-18d %-12d %-12s %-15s\n",
-                   tabla_particiones[i].id,
-                   estado_str,
-                   tabla_particiones[i].direccion_inicio,
-                   tabla_particiones[i].tamano,
-                   "---",
-                   "---");
         }
     }
-    printf("===============================================================\n");
+    if (correcta && en_numero) {
+        referenciar_pagina(proceso < 0 ? 0 : proceso, valor);
+        cuenta++;
+    } else if (correcta && proceso >= 0) {
+        correcta = 0;
+    }
+    if (!correcta) {
+        printf("Error: caracter inesperado '%c' en la referencia %ld de la traza.\n",
+               c, cuenta + 1);
+    }
+    free(bufer);
+    *referencias = cuenta;
+    return correcta;
 }
 
 /**
- * Muestra visualmente el vector de memoria
+ * Compara la tasa de fallos de pagina de las politicas de reemplazo con
+ * una traza de referencias. Opciones 'clave=valor':
+ *   traza=RUTA   archivo de referencias (obligatorio; se lee una vez por
+ *                politica y cantidad de marcos)
+ *   marcos=N[,N...]  marcos de memoria fisica (64)
+ *   politica=fifo|lru|reloj|arc|todas  politicas a comparar (todas)
  */
-void mostrar_memoria(void) {
+int ejecutar_reemplazo(int argc, char *argv[]) {
+    FILE *traza;
+    const char *ruta;
+    const char *politica;
+    char *cursor;
+    long referencias;
+    long marcos;
     int i;
+    int p;
+    int correcta;
+    double inicio;
+    double segundos;
     
-    printf("\n========== VISUALIZACION DE MEMORIA ==========\n");
-    printf("Leyenda: [-1] = Libre, [N] = Proceso ID N\n");
-    printf("----------------------------------------------\n");
-    
-    for (i = 0; i < tamano_total_memoria; i++) {
-        if (i % 20 == 0 && i > 0) {
-            printf("\n");  /* Salto de linea cada 20 elementos */
-        }
-        
-        if (memoria[i] == -1) {
-            printf("[ -- ] ");
+    ruta = NULL;
+    politica = "todas";
+    cursor = "64";
+    for (i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "traza=", 6) == 0) {
+            ruta = argv[i] + 6;
+        } else if (strncmp(argv[i], "marcos=", 7) == 0) {
+            cursor = argv[i] + 7;
+        } else if (strncmp(argv[i], "politica=", 9) == 0) {
+            politica = argv[i] + 9;
         } else {
-            printf("[P%-3d] ", memoria[i]);
+            printf("Error: opcion desconocida '%s'.\n", argv[i]);
+            return 1;
         }
     }
-    
-    printf("\n==============================================\n");
-}
-
-/**
- * Libera toda la memoria asignada dinamicamente
- */
-void liberar_recursos(void) {
-    Proceso *actual;
-    Proceso *temp;
-    
-    /* Liberar lista de procesos */
-    actual = lista_procesos;
-    while (actual != NULL) {
-        temp = actual;
-        actual = actual->siguiente;
-        free(temp);
-    }
-    
-    /* Liberar vector de memoria y tabla de particiones */
-    if (memoria != NULL) {
-        free(memoria);
+    if (ruta == NULL) {
+        printf("Error: falta la traza de referencias (traza=archivo).\n");
+        return 1;
     }
-    if (tabla_particiones != NULL) {
-        free(tabla_particiones);
+    if (strcmp(politica, "todas") != 0 && buscar_reemplazo(politica) == -1) {
+        printf("Error: politica de reemplazo desconocida '%s'.\n", politica);
+        return 1;
     }
     
-    printf("\n>>> Recursos liberados. Programa finalizado.\n");
+    /* Solo cuentan los marcos: sin vector de memoria y paginas de 1 KB */
+    memoria_compacta = 1;
+    printf("=== REEMPLAZO DE PAGINAS ===\n");
+    printf("Traza: %s\n", ruta);
+    printf("%-8s %-8s %14s %14s %10s %10s %9s\n", "Marcos", "Politica", "Referencias",
+           "Fallos", "Fallos(%)", "Tiempo(s)", "Mref/s");
+    while (*cursor != '\0') {
+        marcos = strtol(cursor, &cursor, 10);
+        if (marcos < 1 || marcos > INT_MAX / 2 || (*cursor != ',' && *cursor != '\0')) {
+            printf("Error: cantidad de marcos invalida.\n");
+            return 1;
+        }
+        if (*cursor == ',') {
+            cursor++;
+        }
+        for (p = REEMPLAZO_FIFO; p < NUM_REEMPLAZOS; p++) {
+            if (strcmp(politica, "todas") != 0 && strcmp(politica, nombres_reemplazo[p]) != 0) {
+                continue;
+            }
+            traza = fopen(ruta, "rb");
+            if (traza == NULL) {
+                printf("Error: No se pudo abrir la traza '%s'.\n", ruta);
+                return 1;
+            }
+            politica_reemplazo = p;
+            configurar_paginacion((int)marcos, 1, 1);
+            inicio = tiempo_ns();
+            correcta = reproducir_traza(traza, &referencias);
+            segundos = (tiempo_ns() - inicio) / 1e9;
+            fclose(traza);
+            if (!correcta) {
+                destruir_estado();
+                return 1;
+            }
+            printf("%-8ld %-8s %14ld %14ld %10.3f %10.3f %9.1f\n", marcos, nombres_reemplazo[p],
+                   referencias, fallos_pagina,
+                   referencias > 0 ? 100.0 * fallos_pagina / referencias : 0.0, segundos,
+                   segundos > 0.0 ? referencias / segundos / 1e6 : 0.0);
+            destruir_estado();
+        }
+    }
+    return 0;
 }
 
 /* ==================== FUNCION PRINCIPAL ==================== */
 
-int main(void) {
+int main(int argc, char *argv[]) {
     int opcion;
+    int restaurada;
+    double inicio;
     
     /* Inicializar generador de numeros aleatorios */
-    srand((unsigned int)time(NULL));
+    semilla_aleatoria((unsigned long)time(NULL));
+    
+    /* Opcion global: memoria compacta (una extension por particion) */
+    if (argc >= 2 && strcmp(argv[1], "--compacta") == 0) {
+        memoria_compacta = 1;
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
+    
+    /* Modo por lotes: sin menu ni mensajes por operacion */
+    if (argc == 3 && strcmp(argv[1], "--lote") == 0) {
+        return ejecutar_lote(argv[2]);
+    }
+    
+    /* Simulacion de eventos discretos en tiempo virtual */
+    if (argc >= 2 && strcmp(argv[1], "--sim") == 0) {
+        return ejecutar_simulacion(argc - 2, argv + 2);
+    }
+    
+    /* Escalabilidad de la asignacion con varios hilos */
+    if (argc >= 2 && strcmp(argv[1], "--concurrente") == 0) {
+        return ejecutar_concurrente(argc - 2, argv + 2);
+    }
+    
+    /* TLB y tablas de paginas con cargas de referencias generadas */
+    if (argc >= 2 && strcmp(argv[1], "--paginacion") == 0) {
+        return ejecutar_paginacion(argc - 2, argv + 2);
+    }
+    
+    /* Tasa de fallos de las politicas de reemplazo con una traza */
+    if (argc >= 2 && strcmp(argv[1], "--reemplazo") == 0) {
+        return ejecutar_reemplazo(argc - 2, argv + 2);
+    }
+    
+    /* Prueba de rendimiento con semilla fija */
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) {
+        return ejecutar_benchmark(argc - 2, argv + 2);
+    }
+    
+    /* Menu interactivo, desde cero o desde una instantanea */
+    restaurada = 0;
+    if (argc == 3 && strcmp(argv[1], "--cargar") == 0) {
+        inicio = tiempo_ns();
+        if (!cargar_instantanea(argv[2])) {
+            return 1;
+        }
+        printf(">>> Instantanea '%s' restaurada: %d particiones, %d procesos, "
+               "%ld terminados en %.3f ms.\n", argv[2], num_particiones, procesos_en_indice,
+               num_terminados, (tiempo_ns() - inicio) / 1e6);
+        restaurada = 1;
+    } else if (argc != 1) {
+        mostrar_uso(argv[0]);
+        return 1;
+    }
     
     printf("╔════════════════════════════════════════════════════════╗\n");
     printf("║  SIMULADOR DE GESTION DE MEMORIA PARTICIONADA FIJA     ║\n");
-    printf("║  Algoritmo: Primer Ajuste (First Fit)                  ║\n");
+    printf("║  Politicas: Primer, Mejor, Peor y Siguiente Ajuste     ║\n");
     printf("╚════════════════════════════════════════════════════════╝\n");
     
     /* Inicializar el sistema de memoria */
-    inicializar_memoria();
+    if (!restaurada) {
+        inicializar_memoria();
+        seleccionar_cola();
+    }
     
     /* Menu interactivo */
     do {
@@ -491,6 +8713,17 @@ int main(void) {
         printf("║  4. Ver Tabla de Particiones                   ║\n");
         printf("║  5. Ver Memoria Asignada                       ║\n");
         printf("║  6. Ver Todas las Tablas                       ║\n");
+        printf("║  7. Ver Estadisticas                           ║\n");
+        printf("║  8. Ver Procesos Terminados                    ║\n");
+        printf("║  9. Guardar Estado                             ║\n");
+        printf("║ 10. Ver Memoria por Tramos                     ║\n");
+        printf("║ 11. Ver Mapa de Memoria                        ║\n");
+        printf("║ 12. Traducir Direccion (paginacion)            ║\n");
+        printf("║ 13. Compactar Memoria                          ║\n");
+        printf("║ 14. Exportar Metricas (JSON/CSV)               ║\n");
+#if defined(PERFILADO)
+        printf("║ 15. Ver Perfil                                 ║\n");
+#endif
         printf("║  0. Salir                                      ║\n");
         printf("╚════════════════════════════════════════════════╝\n");
         printf("Seleccione una opcion: ");
@@ -517,6 +8750,35 @@ int main(void) {
                 mostrar_tabla_particiones();
                 mostrar_memoria();
                 break;
+            case 7:
+                mostrar_estadisticas();
+                break;
+            case 8:
+                mostrar_procesos_terminados();
+                break;
+            case 9:
+                guardar_estado();
+                break;
+            case 10:
+                mostrar_memoria_tramos();
+                break;
+            case 11:
+                mostrar_mapa_memoria();
+                break;
+            case 12:
+                traducir_interactivo();
+                break;
+            case 13:
+                compactar_interactivo();
+                break;
+            case 14:
+                exportar_interactivo();
+                break;
+#if defined(PERFILADO)
+            case 15:
+                mostrar_perfil();
+                break;
+#endif
             case 0:
                 printf("\nSaliendo del programa...\n");
                 break;